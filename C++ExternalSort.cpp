@@ -0,0 +1,520 @@
+#include "C++ExternalSort.hpp"
+#include "C++SortingNetworks.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Movement: Every int written to a run file or the output
+// Comparison: Every comparison made by the chunk sort or the loser tree
+
+// Smallest I/O buffer worth issuing, in ints (256 KiB)
+constexpr std::size_t MIN_IO_BUFFER_INTS = 64 * 1024;
+
+static std::FILE* openFile(const std::string& path, const char* mode) {
+    std::FILE* file = std::fopen(path.c_str(), mode);
+    if (file == nullptr) {
+        throw std::runtime_error("externalSort: cannot open " + path);
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0); // Buffers are managed here, stdio would only add a copy
+    return file;
+}
+
+static void closeFile(std::FILE* file, const std::string& path) {
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error("externalSort: cannot close " + path);
+    }
+}
+
+// Reads up to count ints, returning how many were read (fewer only at end of file)
+static std::size_t readInts(std::FILE* file, int* buffer, std::size_t count) {
+    std::size_t read = std::fread(buffer, sizeof(int), count, file);
+    if (read < count && std::ferror(file)) {
+        throw std::runtime_error("externalSort: read failed");
+    }
+    return read;
+}
+
+static void writeInts(std::FILE* file, const int* buffer, std::size_t count) {
+    if (std::fwrite(buffer, sizeof(int), count, file) != count) {
+        throw std::runtime_error("externalSort: write failed");
+    }
+}
+
+// Owns the temporary run files and deletes whatever is left of them on destruction
+class runFiles {
+public:
+    explicit runFiles(const std::string& tempDirectory) {
+        directory = tempDirectory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(tempDirectory);
+        prefix = "externalSort-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-";
+    }
+
+    ~runFiles() {
+        for (const std::string& path : paths) {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+    }
+
+    std::string create() {
+        paths.push_back((directory / (prefix + std::to_string(nextId++) + ".bin")).string());
+        return paths.back();
+    }
+
+    void remove(const std::string& path) {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        paths.erase(std::find(paths.begin(), paths.end(), path));
+    }
+
+private:
+    std::filesystem::path directory;
+    std::string prefix;
+    std::vector<std::string> paths;
+    int nextId = 0;
+};
+
+// Streams a sorted run through two buffers, reading the next one while the current one is consumed.
+// A run already in memory is read in place, as one buffer that is never refilled
+class runReader {
+public:
+    runReader(const std::string& path, std::size_t bufferInts) : active(bufferInts), standby(bufferInts) {
+        file = openFile(path, "rb");
+        count = readInts(file, active.data(), active.size());
+        current = active.data();
+        prefetch();
+    }
+
+    runReader(const int* run, std::size_t runInts) : file(nullptr), current(run), count(runInts) {}
+
+    ~runReader() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    bool empty() const {
+        return position == count;
+    }
+
+    int front() const {
+        return current[position];
+    }
+
+    void pop() {
+        if (++position == count) {
+            refill();
+        }
+    }
+
+private:
+    void prefetch() {
+        if (count == active.size()) {
+            pending = std::async(std::launch::async, readInts, file, standby.data(), standby.size());
+        }
+    }
+
+    void refill() {
+        if (!pending.valid()) {
+            return; // The last read was short, so the run is finished
+        }
+        count = pending.get();
+        position = 0;
+        std::swap(active, standby);
+        current = active.data();
+        prefetch();
+    }
+
+    std::FILE* file;
+    std::vector<int> active, standby;
+    const int* current;
+    std::size_t position = 0, count = 0;
+    std::future<std::size_t> pending;
+};
+
+// Collects output through two buffers, writing a full one in the background while the other fills
+class runWriter {
+public:
+    runWriter(const std::string& path, std::size_t bufferInts) : path(path), active(bufferInts), standby(bufferInts) {
+        file = openFile(path, "wb");
+    }
+
+    ~runWriter() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    void push(int value) {
+        active[count++] = value;
+        if (count == active.size()) {
+            flush();
+        }
+    }
+
+    void finish() {
+        flush();
+        if (pending.valid()) {
+            pending.get();
+        }
+        std::FILE* closing = file;
+        file = nullptr;
+        closeFile(closing, path);
+    }
+
+private:
+    void flush() {
+        if (pending.valid()) {
+            pending.get();
+        }
+        if (count > 0) {
+            pending = std::async(std::launch::async, writeInts, file, active.data(), count);
+            std::swap(active, standby);
+            count = 0;
+        }
+    }
+
+    std::string path;
+    std::FILE* file;
+    std::vector<int> active, standby;
+    std::size_t count = 0;
+    std::future<void> pending;
+};
+
+// Tournament tree over k runs: each internal node holds the loser of its match, node 0 the overall winner
+// Replacing the winner only replays the matches on its leaf-to-root path, log2(k) comparisons
+class loserTree {
+public:
+    loserTree(std::vector<runReader*>& runs, countingPolicy counter) : runs(runs), counter(counter) {
+        leaves = 1;
+        while (leaves < static_cast<int>(runs.size())) {
+            leaves *= 2;
+        }
+
+        tree.assign(leaves, 0);
+        std::vector<int> winners(2 * leaves);
+        for (int i = 0; i < leaves; i++) {
+            winners[leaves + i] = i;
+        }
+        for (int node = leaves - 1; node >= 1; node--) {
+            int a = winners[2 * node], b = winners[2 * node + 1];
+            bool aWins = beats(a, b);
+            winners[node] = aWins ? a : b;
+            tree[node] = aWins ? b : a;
+        }
+        tree[0] = winners[1];
+    }
+
+    bool empty() const {
+        return exhausted(tree[0]);
+    }
+
+    runReader& winner() {
+        return *runs[tree[0]];
+    }
+
+    // Call after the winner's run has advanced
+    void replay() {
+        int winner = tree[0];
+        for (int node = (winner + leaves) / 2; node >= 1; node /= 2) {
+            if (beats(tree[node], winner)) {
+                std::swap(tree[node], winner);
+            }
+        }
+        tree[0] = winner;
+    }
+
+private:
+    bool exhausted(int run) const {
+        return run >= static_cast<int>(runs.size()) || runs[run]->empty();
+    }
+
+    // Exhausted runs lose every match, ties go to the lower run so the merge is stable
+    bool beats(int a, int b) {
+        if (exhausted(b)) {
+            return true;
+        }
+        if (exhausted(a)) {
+            return false;
+        }
+        counter.comparison(); // Compare the heads of two runs
+        int x = runs[a]->front(), y = runs[b]->front();
+        return x < y || (x == y && a < b);
+    }
+
+    std::vector<runReader*>& runs;
+    countingPolicy counter;
+    std::vector<int> tree;
+    int leaves;
+};
+
+// Merges the given runs into outputPath through output buffers of bufferInts
+static void mergeReaders(std::vector<runReader*>& runs, const std::string& outputPath, std::size_t bufferInts, sortResults& sortResult) {
+    countingPolicy counter{ sortResult };
+    loserTree tournament(runs, counter);
+    runWriter writer(outputPath, bufferInts);
+    while (!tournament.empty()) {
+        runReader& winner = tournament.winner();
+        writer.push(winner.front()); // Movement
+        counter.movement();
+        winner.pop();
+        tournament.replay();
+    }
+    writer.finish();
+}
+
+// Merges the given run files into outputPath, with every buffer sized to bufferInts
+static void mergeRuns(const std::vector<std::string>& inputs, const std::string& outputPath, std::size_t bufferInts, sortResults& sortResult) {
+    std::vector<std::unique_ptr<runReader>> readers;
+    std::vector<runReader*> runs;
+    for (const std::string& input : inputs) {
+        readers.push_back(std::make_unique<runReader>(input, bufferInts));
+        runs.push_back(readers.back().get());
+    }
+    mergeReaders(runs, outputPath, bufferInts, sortResult);
+}
+
+// Merges groups of maxFanIn runs into longer runs until at most maxFanIn are left, deleting the merged runs
+static std::vector<std::string> reduceRuns(std::vector<std::string> runs, std::size_t maxFanIn, std::size_t bufferInts, runFiles& files, sortResults& sortResult) {
+    while (runs.size() > maxFanIn) {
+        std::vector<std::string> merged;
+        for (std::size_t first = 0; first < runs.size(); first += maxFanIn) {
+            std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(first + maxFanIn, runs.size()));
+            std::string mergedPath = files.create();
+            mergeRuns(group, mergedPath, bufferInts, sortResult);
+            for (const std::string& run : group) {
+                files.remove(run);
+            }
+            merged.push_back(mergedPath);
+        }
+        runs = merged;
+    }
+    return runs;
+}
+
+void externalSort(const std::string& inputPath, const std::string& outputPath, std::size_t memoryBudget, const std::string& tempDirectory,
+    void (*sortChunk)(int[], int, sortResults&), sortResults& sortResult) {
+    std::size_t budgetInts = memoryBudget / sizeof(int);
+
+    // Merging needs at least two runs plus the output, each double buffered
+    if (budgetInts < 6 * MIN_IO_BUFFER_INTS) {
+        throw std::invalid_argument("externalSort: memory budget must be at least " + std::to_string(6 * MIN_IO_BUFFER_INTS * sizeof(int)) + " bytes");
+    }
+
+    runFiles files(tempDirectory);
+    std::vector<std::string> runs;
+    bool wroteOutput = false;
+
+    // Run generation: two chunk buffers so the next chunk is read while the current one is sorted
+    {
+        std::size_t chunkInts = std::min<std::size_t>(budgetInts / 2, INT_MAX);
+        std::vector<int> current(chunkInts), next(chunkInts);
+        std::FILE* input = openFile(inputPath, "rb");
+
+        try {
+            std::size_t currentCount = readInts(input, current.data(), chunkInts);
+            while (currentCount > 0) {
+                std::future<std::size_t> prefetch;
+                if (currentCount == chunkInts) {
+                    prefetch = std::async(std::launch::async, readInts, input, next.data(), chunkInts);
+                }
+
+                sortChunk(current.data(), static_cast<int>(currentCount), sortResult);
+                std::size_t nextCount = prefetch.valid() ? prefetch.get() : 0;
+
+                // A single chunk is the whole file, so it can go straight to the output
+                std::string runPath = runs.empty() && nextCount == 0 ? outputPath : files.create();
+                std::FILE* run = openFile(runPath, "wb");
+                try {
+                    writeInts(run, current.data(), currentCount);
+                }
+                catch (...) {
+                    std::fclose(run);
+                    throw;
+                }
+                closeFile(run, runPath);
+                sortResult.movements += currentCount;
+
+                if (runPath == outputPath) {
+                    wroteOutput = true;
+                    break;
+                }
+                runs.push_back(runPath);
+                currentCount = nextCount;
+                std::swap(current, next);
+            }
+        }
+        catch (...) {
+            std::fclose(input);
+            throw;
+        }
+        closeFile(input, inputPath);
+    }
+
+    if (runs.empty()) {
+        // Either the whole file fit in one chunk, or it was empty and the output still has to be truncated
+        if (!wroteOutput) {
+            closeFile(openFile(outputPath, "wb"), outputPath);
+        }
+        return;
+    }
+
+    // Each merge holds two buffers per input run and two for the output
+    std::size_t maxFanIn = std::max<std::size_t>(2, budgetInts / (2 * MIN_IO_BUFFER_INTS) - 1);
+    runs = reduceRuns(runs, maxFanIn, budgetInts / (2 * (maxFanIn + 1)), files, sortResult);
+
+    mergeRuns(runs, outputPath, budgetInts / (2 * (runs.size() + 1)), sortResult);
+}
+
+void externalSort(const std::string& inputPath, const std::string& outputPath, std::size_t memoryBudget, sortResults& sortResult) {
+    externalSort(inputPath, outputPath, memoryBudget, "", introSort, sortResult);
+}
+
+streamingSorter::streamingSorter(std::size_t memoryBudget, const std::string& tempDirectory, sortResults& sortResult)
+    : budgetInts(memoryBudget / sizeof(int)), tempDirectory(tempDirectory), sortResult(&sortResult) {
+    // Spilling needs the same minimum buffers as externalSort
+    if (memoryBudget > 0 && budgetInts < 6 * MIN_IO_BUFFER_INTS) {
+        throw std::invalid_argument("streamingSorter: memory budget must be at least " + std::to_string(6 * MIN_IO_BUFFER_INTS * sizeof(int)) + " bytes");
+    }
+}
+
+streamingSorter::streamingSorter(std::size_t memoryBudget) : streamingSorter(memoryBudget, "", uncounted) {}
+
+// Out of line, where runFiles, runReader, and loserTree are complete
+streamingSorter::~streamingSorter() = default;
+
+void streamingSorter::push(const int batch[], int n) {
+    if (tournament) {
+        throw std::logic_error("streamingSorter: push after next");
+    }
+    if (n <= 0) {
+        return;
+    }
+    remaining += n;
+
+    std::vector<int> run(batch, batch + n);
+    sortResult->movements += n; // Copying the batch
+    introSort(run.data(), n, *sortResult);
+
+    // A batch that alone overflows the run memory goes straight to its own file
+    if (budgetInts > 0 && run.size() > budgetInts / 2) {
+        if (!files) {
+            files = std::make_unique<runFiles>(tempDirectory);
+        }
+        std::string path = files->create();
+        std::FILE* file = openFile(path, "wb");
+        try {
+            writeInts(file, run.data(), run.size());
+        }
+        catch (...) {
+            std::fclose(file);
+            throw;
+        }
+        closeFile(file, path);
+        sortResult->movements += n;
+        spilledRuns.push_back(path);
+        return;
+    }
+
+    if (budgetInts > 0 && memoryInts + run.size() > budgetInts / 2) {
+        spillMemoryRuns();
+    }
+    memoryInts += run.size();
+    memoryRuns.push_back(std::move(run));
+
+    // Merging while the newest run is at least as long as the one before keeps run lengths
+    // strictly decreasing, like a binary counter, so each value is merged O(log batches) times
+    while (memoryRuns.size() >= 2) {
+        std::vector<int>& first = memoryRuns[memoryRuns.size() - 2];
+        std::vector<int>& second = memoryRuns.back();
+        if (first.size() > second.size() || first.size() + second.size() > INT_MAX) {
+            break;
+        }
+
+        std::vector<int> merged(first.size() + second.size());
+        sortResult->comparisons += networkMergeRuns(first.data(), static_cast<int>(first.size()), second.data(), static_cast<int>(second.size()), merged.data());
+        sortResult->movements += merged.size();
+        memoryRuns.pop_back();
+        memoryRuns.back() = std::move(merged);
+    }
+}
+
+// Merges every run held in memory into one temporary file
+void streamingSorter::spillMemoryRuns() {
+    if (memoryRuns.empty()) {
+        return;
+    }
+    if (!files) {
+        files = std::make_unique<runFiles>(tempDirectory);
+    }
+
+    std::vector<std::unique_ptr<runReader>> memoryReaders;
+    std::vector<runReader*> spilling;
+    for (const std::vector<int>& run : memoryRuns) {
+        memoryReaders.push_back(std::make_unique<runReader>(run.data(), run.size()));
+        spilling.push_back(memoryReaders.back().get());
+    }
+
+    std::string path = files->create();
+    mergeReaders(spilling, path, MIN_IO_BUFFER_INTS, *sortResult);
+    spilledRuns.push_back(path);
+    memoryRuns.clear();
+    memoryInts = 0;
+}
+
+// Ends the input: reduces the spilled runs to what the budget left over can buffer, then builds the loser tree
+void streamingSorter::startMerge() {
+    if (!spilledRuns.empty()) {
+        std::size_t readBudget = budgetInts - memoryInts;
+        std::size_t maxFanIn = std::max<std::size_t>(2, readBudget / (2 * MIN_IO_BUFFER_INTS) - 1);
+        spilledRuns = reduceRuns(spilledRuns, maxFanIn, readBudget / (2 * (maxFanIn + 1)), *files, *sortResult);
+        for (const std::string& path : spilledRuns) {
+            readers.push_back(std::make_unique<runReader>(path, readBudget / (2 * spilledRuns.size())));
+        }
+    }
+    for (const std::vector<int>& run : memoryRuns) {
+        readers.push_back(std::make_unique<runReader>(run.data(), run.size()));
+    }
+
+    for (const std::unique_ptr<runReader>& reader : readers) {
+        runs.push_back(reader.get());
+    }
+    tournament = std::make_unique<loserTree>(runs, countingPolicy{ *sortResult });
+}
+
+bool streamingSorter::next(int& value) {
+    if (!tournament) {
+        startMerge();
+    }
+    if (tournament->empty()) {
+        return false;
+    }
+
+    runReader& winner = tournament->winner();
+    value = winner.front(); // Movement
+    sortResult->movements++;
+    winner.pop();
+    tournament->replay();
+    remaining--;
+    return true;
+}
+
+std::size_t streamingSorter::next(int out[], std::size_t count) {
+    std::size_t taken = 0;
+    while (taken < count && next(out[taken])) {
+        taken++;
+    }
+    return taken;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "C++SortingAlgorithms.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sorts a binary file of native-endian ints that may be larger than memory.
+ *
+ * The input is read in chunks that fit the memory budget, each chunk is sorted with
+ * sortChunk and spilled to a temporary run file, and the runs are k-way merged
+ * through a loser tree into the output. Reads and writes use large sequential buffers,
+ * with the next buffer filled in the background while the current one is processed.
+ * If there are more runs than the budget allows buffers for, they are merged in several passes.
+ *
+ * @param inputPath     File of raw ints to sort.
+ * @param outputPath    File that receives the sorted ints; may not be the input file.
+ * @param memoryBudget  Upper bound in bytes for all sort and I/O buffers (sortChunk must sort in place).
+ * @param tempDirectory Directory for the run files, empty uses the system temporary directory.
+ * @param sortChunk     In-memory sort applied to each chunk.
+ * @param sortResult    Struct to store the sorting performance metrics.
+ * @throws std::runtime_error if a file cannot be opened, read, or written.
+ * @throws std::invalid_argument if the memory budget is too small to hold the minimum buffers.
+ */
+void externalSort(const std::string& inputPath, const std::string& outputPath, std::size_t memoryBudget, const std::string& tempDirectory,
+    void (*sortChunk)(int[], int, sortResults&), sortResults& sortResult);
+
+/**
+ * @brief Sorts a binary file of native-endian ints with Intro Sort chunks and the system temporary directory.
+ *
+ * @param inputPath     File of raw ints to sort.
+ * @param outputPath    File that receives the sorted ints; may not be the input file.
+ * @param memoryBudget  Upper bound in bytes for all sort and I/O buffers.
+ * @param sortResult    Struct to store the sorting performance metrics.
+ * @throws std::runtime_error if a file cannot be opened, read, or written.
+ * @throws std::invalid_argument if the memory budget is too small to hold the minimum buffers.
+ */
+void externalSort(const std::string& inputPath, const std::string& outputPath, std::size_t memoryBudget, sortResults& sortResult);
+
+class runFiles;
+class runReader;
+class loserTree;
+
+/**
+ * @class streamingSorter
+ * @brief Sorts values that arrive in batches, yielding them in order as soon as the input ends.
+ *
+ * push() sorts each batch into a run with Intro Sort. Whenever the newest run is at least as
+ * long as the one before it, the two are merged with the sorting network merge kernel, so at
+ * most about log2(batches) runs are ever held. next() k-way merges the runs through the
+ * external sort's loser tree: the first value costs one tree build, O(runs) comparisons, and
+ * every later value log2(runs), instead of waiting for a sort of everything pushed.
+ *
+ * With a memory budget, runs that would grow past half of it are merged into a temporary file
+ * and the file runs are read back through the same double-buffered readers as externalSort,
+ * with extra merge passes on the first next() if there are too many of them.
+ */
+class streamingSorter {
+public:
+    /**
+     * @param memoryBudget  Upper bound in bytes for the runs and I/O buffers, 0 keeps everything in memory.
+     * @param tempDirectory Directory for spilled runs, empty uses the system temporary directory.
+     * @param sortResult    Struct to store the sorting performance metrics.
+     * @throws std::invalid_argument if a nonzero memory budget is too small to hold the minimum buffers.
+     */
+    streamingSorter(std::size_t memoryBudget, const std::string& tempDirectory, sortResults& sortResult);
+
+    /**
+     * @param memoryBudget  Upper bound in bytes for the runs and I/O buffers, 0 keeps everything in memory.
+     * @throws std::invalid_argument if a nonzero memory budget is too small to hold the minimum buffers.
+     */
+    explicit streamingSorter(std::size_t memoryBudget = 0);
+
+    ~streamingSorter();
+
+    streamingSorter(const streamingSorter&) = delete;
+    streamingSorter& operator=(const streamingSorter&) = delete;
+
+    /**
+     * @brief Sorts a batch into a new run. Batches larger than half the memory budget are spilled whole.
+     *
+     * @param batch The values to add, copied before push returns.
+     * @param n     The number of values in the batch.
+     * @throws std::logic_error if next() has already been called.
+     * @throws std::runtime_error if a spilled run cannot be written.
+     */
+    void push(const int batch[], int n);
+
+    /**
+     * @brief Takes the smallest value not yet taken, ending the input on the first call.
+     *
+     * @param value Receives the value.
+     * @return false once every pushed value has been taken.
+     * @throws std::runtime_error if a spilled run cannot be read.
+     */
+    bool next(int& value);
+
+    /**
+     * @brief Takes up to count of the smallest values not yet taken, in order.
+     *
+     * @return The number of values written to out, less than count only at the end.
+     * @throws std::runtime_error if a spilled run cannot be read.
+     */
+    std::size_t next(int out[], std::size_t count);
+
+    /**
+     * @brief Number of values pushed and not yet taken.
+     */
+    std::size_t size() const { return remaining; }
+
+    /**
+     * @brief Number of runs written to temporary files so far.
+     */
+    std::size_t spilledRunCount() const { return spilledRuns.size(); }
+
+private:
+    void spillMemoryRuns();
+    void startMerge();
+
+    std::size_t budgetInts;
+    std::string tempDirectory;
+    sortResults* sortResult;
+    sortResults uncounted{};
+
+    std::vector<std::vector<int>> memoryRuns;
+    std::size_t memoryInts = 0, remaining = 0;
+    std::unique_ptr<runFiles> files;
+    std::vector<std::string> spilledRuns;
+
+    std::vector<std::unique_ptr<runReader>> readers;
+    std::vector<runReader*> runs;
+    std::unique_ptr<loserTree> tournament;
+};
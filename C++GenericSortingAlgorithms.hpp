@@ -0,0 +1,267 @@
+#pragma once
+
+#include "C++SortingAlgorithms.hpp"
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Generic versions of the sorting algorithms for any random-access range.
+// Elements are ordered by comp(proj(a), proj(b)) and are moved, never copied,
+// and all indexing uses the iterator's difference_type so ranges past 2^31 elements work.
+// The counting policy sees the same comparisons and movements as the int versions.
+
+/**
+ * @struct identityProjection
+ * @brief Projection that returns its argument unchanged, so elements are compared directly.
+ */
+struct identityProjection {
+    template <typename T>
+    T&& operator()(T&& value) const {
+        return std::forward<T>(value);
+    }
+};
+
+// Ranges at or below this size are handed to insertionSort by the generic quickSort
+constexpr std::ptrdiff_t GENERIC_SORT_CUTOFF = 16;
+
+// Returns true when a orders before b, counting the comparison
+template <typename T, typename U, typename Compare, typename Projection, typename CountPolicy>
+bool projectedLess(const T& a, const U& b, Compare& comp, Projection& proj, CountPolicy& counter) {
+    counter.comparison();
+    return comp(std::invoke(proj, a), std::invoke(proj, b));
+}
+
+/**
+ * @brief Sorts a range using the Insertion Sort algorithm.
+ *
+ * @param first      Iterator to the first element of the range.
+ * @param last       Iterator one past the last element of the range.
+ * @param comp       Strict weak ordering applied to the projected elements.
+ * @param proj       Projection applied to each element before comparing.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = identityProjection, typename CountPolicy = noCountingPolicy>
+void insertionSort(RandomIt first, RandomIt last, Compare comp = {}, Projection proj = {}, CountPolicy counter = {}) {
+    if (first == last) {
+        return;
+    }
+
+    for (RandomIt i = first + 1; i != last; ++i) {
+        if (!projectedLess(*i, *(i - 1), comp, proj, counter)) {
+            continue; // Already in place
+        }
+
+        auto key = std::move(*i); // Movement
+        counter.movement();
+        RandomIt j = i;
+        do {
+            *j = std::move(*(j - 1)); // Movement
+            counter.movement();
+            --j;
+        } while (j != first && projectedLess(key, *(j - 1), comp, proj, counter));
+
+        *j = std::move(key); // Movement
+        counter.movement();
+    }
+}
+
+// Restores the max-heap property below index hole of the heap first[0..n), moving rather than swapping
+template <typename RandomIt, typename Compare, typename Projection, typename CountPolicy>
+void siftDown(RandomIt first, typename std::iterator_traits<RandomIt>::difference_type hole,
+    typename std::iterator_traits<RandomIt>::difference_type n, Compare& comp, Projection& proj, CountPolicy& counter) {
+    using difference = typename std::iterator_traits<RandomIt>::difference_type;
+
+    auto value = std::move(first[hole]); // Movement
+    counter.movement();
+
+    difference child = 2 * hole + 1;
+    while (child < n) {
+        if (child + 1 < n && projectedLess(first[child], first[child + 1], comp, proj, counter)) {
+            child++;
+        }
+        if (!projectedLess(value, first[child], comp, proj, counter)) {
+            break;
+        }
+
+        first[hole] = std::move(first[child]); // Movement
+        counter.movement();
+        hole = child;
+        child = 2 * hole + 1;
+    }
+
+    first[hole] = std::move(value); // Movement
+    counter.movement();
+}
+
+/**
+ * @brief Sorts a range using the Heap Sort algorithm.
+ *
+ * @param first      Iterator to the first element of the range.
+ * @param last       Iterator one past the last element of the range.
+ * @param comp       Strict weak ordering applied to the projected elements.
+ * @param proj       Projection applied to each element before comparing.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = identityProjection, typename CountPolicy = noCountingPolicy>
+void heapSort(RandomIt first, RandomIt last, Compare comp = {}, Projection proj = {}, CountPolicy counter = {}) {
+    using difference = typename std::iterator_traits<RandomIt>::difference_type;
+    difference n = last - first;
+
+    for (difference i = n / 2 - 1; i >= 0; i--) {
+        siftDown(first, i, n, comp, proj, counter);
+    }
+
+    for (difference i = n - 1; i > 0; i--) {
+        std::iter_swap(first, first + i); // Swap counts as 2 movements
+        counter.movement(2);
+        siftDown(first, difference(0), i, comp, proj, counter);
+    }
+}
+
+// Introspective Quick Sort loop over [first, last), see introSortLoop in C++SortingAlgorithms.cpp
+template <typename RandomIt, typename Compare, typename Projection, typename CountPolicy>
+void quickSortLoop(RandomIt first, RandomIt last, int depthLimit, Compare& comp, Projection& proj, CountPolicy& counter) {
+    while (last - first > GENERIC_SORT_CUTOFF) {
+        if (depthLimit == 0) {
+            heapSort(first, last, comp, proj, counter);
+            return;
+        }
+        depthLimit--;
+
+        // Median of three leaves sentinels at both ends and the pivot in the middle
+        RandomIt low = first, mid = first + (last - first) / 2, high = last - 1;
+        if (projectedLess(*mid, *low, comp, proj, counter)) {
+            std::iter_swap(mid, low);
+            counter.movement(2);
+        }
+        if (projectedLess(*high, *low, comp, proj, counter)) {
+            std::iter_swap(high, low);
+            counter.movement(2);
+        }
+        if (projectedLess(*high, *mid, comp, proj, counter)) {
+            std::iter_swap(high, mid);
+            counter.movement(2);
+        }
+
+        // The pivot is parked next to the low sentinel so it does not move during the scan
+        std::iter_swap(low + 1, mid);
+        counter.movement(2);
+        RandomIt pivot = low + 1;
+
+        RandomIt i = pivot, j = high;
+        while (true) {
+            do {
+                ++i;
+            } while (projectedLess(*i, *pivot, comp, proj, counter));
+            do {
+                --j;
+            } while (projectedLess(*pivot, *j, comp, proj, counter));
+
+            if (i >= j) {
+                break;
+            }
+            std::iter_swap(i, j); // Swap counts as 2 movements
+            counter.movement(2);
+        }
+
+        // Drop the pivot into its final slot
+        std::iter_swap(pivot, j);
+        counter.movement(2);
+
+        // Recurse into the smaller side and loop on the larger one so stack depth stays O(log n)
+        if (j - first < last - (j + 1)) {
+            quickSortLoop(first, j, depthLimit, comp, proj, counter);
+            first = j + 1;
+        }
+        else {
+            quickSortLoop(j + 1, last, depthLimit, comp, proj, counter);
+            last = j;
+        }
+    }
+
+    insertionSort(first, last, comp, proj, counter);
+}
+
+/**
+ * @brief Sorts a range using the Quick Sort algorithm.
+ *
+ * Uses the same introspective scheme as introSort: median-of-three pivot, Heap Sort
+ * past a depth of 2 * log2(n), and Insertion Sort for small ranges.
+ *
+ * @param first      Iterator to the first element of the range.
+ * @param last       Iterator one past the last element of the range.
+ * @param comp       Strict weak ordering applied to the projected elements.
+ * @param proj       Projection applied to each element before comparing.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = identityProjection, typename CountPolicy = noCountingPolicy>
+void quickSort(RandomIt first, RandomIt last, Compare comp = {}, Projection proj = {}, CountPolicy counter = {}) {
+    int depthLimit = 0;
+    for (auto size = last - first; size > 1; size >>= 1) {
+        depthLimit += 2; // 2 * floor(log2(n))
+    }
+
+    quickSortLoop(first, last, depthLimit, comp, proj, counter);
+}
+
+// Sorts [first, last) with buffer holding room for at least half the range
+template <typename RandomIt, typename BufferIt, typename Compare, typename Projection, typename CountPolicy>
+void mergeSortLoop(RandomIt first, RandomIt last, BufferIt buffer, Compare& comp, Projection& proj, CountPolicy& counter) {
+    auto n = last - first;
+    if (n < 2) {
+        return;
+    }
+
+    RandomIt mid = first + n / 2;
+    mergeSortLoop(first, mid, buffer, comp, proj, counter);
+    mergeSortLoop(mid, last, buffer, comp, proj, counter);
+
+    // Runs that are already in order need no merge
+    if (!projectedLess(*mid, *(mid - 1), comp, proj, counter)) {
+        return;
+    }
+
+    // Move the left run out, then merge it with the right run back into place
+    BufferIt bufferEnd = std::move(first, mid, buffer);
+    counter.movement(mid - first);
+
+    BufferIt i = buffer;
+    RandomIt j = mid, k = first;
+    while (i != bufferEnd && j != last) {
+        if (projectedLess(*j, *i, comp, proj, counter)) {
+            *k = std::move(*j); // Movement, right run wins only when strictly smaller so the sort is stable
+            ++j;
+        }
+        else {
+            *k = std::move(*i); // Movement
+            ++i;
+        }
+        counter.movement();
+        ++k;
+    }
+
+    // Whatever is left of the right run is already in place
+    counter.movement(bufferEnd - i);
+    std::move(i, bufferEnd, k);
+}
+
+/**
+ * @brief Sorts a range using the Merge Sort algorithm.
+ *
+ * Stable. Allocates one scratch buffer of n / 2 elements for the whole sort,
+ * so the element type must be default constructible.
+ *
+ * @param first      Iterator to the first element of the range.
+ * @param last       Iterator one past the last element of the range.
+ * @param comp       Strict weak ordering applied to the projected elements.
+ * @param proj       Projection applied to each element before comparing.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename RandomIt, typename Compare = std::less<>, typename Projection = identityProjection, typename CountPolicy = noCountingPolicy>
+void mergeSort(RandomIt first, RandomIt last, Compare comp = {}, Projection proj = {}, CountPolicy counter = {}) {
+    using value = typename std::iterator_traits<RandomIt>::value_type;
+
+    std::vector<value> buffer(static_cast<std::size_t>((last - first) / 2));
+    mergeSortLoop(first, last, buffer.begin(), comp, proj, counter);
+}
@@ -0,0 +1,184 @@
+#include "C++InputGenerators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fewest elements worth handing to a separate thread
+constexpr int GENERATOR_GRAIN = 1 << 16;
+
+// SplitMix64 finalizer: a bijective mix where every input bit affects every output bit
+static std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t randomAt(std::uint64_t seed, std::uint64_t index) {
+    // Mixing the seed first keeps the streams of nearby seeds unrelated
+    return mix64(mix64(seed) + (index + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+// Maps a random number onto [0, bound) with a multiply instead of a biased modulo
+static std::uint64_t uniformBelow(std::uint64_t random, std::uint64_t bound) {
+    return ((random >> 32) * bound) >> 32;
+}
+
+// Random permutation of [0, n) evaluated one index at a time: a 4-round Feistel network is a
+// bijection on [0, 4^halfBits) and cycle walking restricts it to [0, n) without losing that
+static std::uint64_t permuteIndex(std::uint64_t index, std::uint64_t n, int halfBits, std::uint64_t seed) {
+    const std::uint64_t mask = (std::uint64_t(1) << halfBits) - 1;
+    do {
+        std::uint64_t left = index >> halfBits, right = index & mask;
+        for (std::uint64_t round = 0; round < 4; round++) {
+            std::uint64_t next = left ^ (randomAt(seed + round, right) & mask);
+            left = right;
+            right = next;
+        }
+        index = (left << halfBits) | right;
+    } while (index >= n);
+    return index;
+}
+
+// Runs fill(begin, end) over [0, n) on up to threadCount threads, the caller taking the first slice
+template <typename Fill>
+static void fillParallel(int n, int threadCount, Fill fill) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    threadCount = std::max(1, std::min(threadCount, n / GENERATOR_GRAIN));
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        int begin = static_cast<int>(static_cast<long long>(n) * t / threadCount);
+        int end = static_cast<int>(static_cast<long long>(n) * (t + 1) / threadCount);
+        threads.emplace_back(fill, begin, end);
+    }
+    fill(0, static_cast<int>(static_cast<long long>(n) / threadCount));
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void generateInput(int arr[], int n, int distribution, std::uint64_t seed, int threadCount, int swaps) {
+    if (n <= 0) {
+        return;
+    }
+
+    switch (distribution) {
+    case ascendingInput:
+    case nearlySortedInput:
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                arr[i] = i;
+            }
+        });
+        break;
+
+    case descendingInput:
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                arr[i] = (n - 1) - i;
+            }
+        });
+        break;
+
+    case randomInput: {
+        int halfBits = 1;
+        while ((std::uint64_t(1) << (2 * halfBits)) < static_cast<std::uint64_t>(n)) {
+            halfBits++;
+        }
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                arr[i] = static_cast<int>(permuteIndex(i, n, halfBits, seed));
+            }
+        });
+        break;
+    }
+
+    case fewUniqueInput:
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                arr[i] = static_cast<int>(uniformBelow(randomAt(seed, i), FEW_UNIQUE_VALUES));
+            }
+        });
+        break;
+
+    case sawtoothInput: {
+        int period = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(n))));
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                arr[i] = i % period;
+            }
+        });
+        break;
+    }
+
+    case organPipeInput:
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                arr[i] = i < n / 2 ? i : (n - 1) - i;
+            }
+        });
+        break;
+
+    case zipfInput: {
+        // Inverse transform of the continuous approximation P(v) ~ 1 / ((v + 1) ln(n + 1))
+        double logRange = std::log(static_cast<double>(n) + 1);
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                double u = static_cast<double>(randomAt(seed, i) >> 11) * 0x1.0p-53;
+                long long value = static_cast<long long>(std::exp(u * logRange)) - 1;
+                arr[i] = static_cast<int>(std::min<long long>(std::max(value, 0LL), n - 1));
+            }
+        });
+        break;
+    }
+
+    case allEqualInput:
+        fillParallel(n, threadCount, [=](int begin, int end) {
+            std::fill(arr + begin, arr + end, 0);
+        });
+        break;
+    }
+
+    // The swaps are few, so they run sequentially on top of the parallel ascending fill
+    if (distribution == nearlySortedInput) {
+        std::uint64_t swapCount = swaps < 0 ? static_cast<std::uint64_t>(n) / NEARLY_SORTED_SWAP_SPACING : static_cast<std::uint64_t>(swaps);
+        for (std::uint64_t k = 0; k < swapCount; k++) {
+            std::swap(arr[uniformBelow(randomAt(seed, 2 * k), n)], arr[uniformBelow(randomAt(seed, 2 * k + 1), n)]);
+        }
+    }
+}
+
+std::string inputDistributionToString(int distribution) {
+    switch (distribution) {
+    case ascendingInput:    return "In Order (Ascending)";
+    case descendingInput:   return "Reverse Order (Descending)";
+    case randomInput:       return "Randomized Order";
+    case fewUniqueInput:    return "Few Unique";
+    case sawtoothInput:     return "Sawtooth";
+    case organPipeInput:    return "Organ Pipe";
+    case zipfInput:         return "Zipf";
+    case nearlySortedInput: return "Nearly Sorted";
+    case allEqualInput:     return "All Equal";
+    default:                return "Unknown Input";
+    }
+}
+
+std::string inputDistributionToKey(int distribution) {
+    switch (distribution) {
+    case ascendingInput:    return "ascending";
+    case descendingInput:   return "descending";
+    case randomInput:       return "random";
+    case fewUniqueInput:    return "fewUnique";
+    case sawtoothInput:     return "sawtooth";
+    case organPipeInput:    return "organPipe";
+    case zipfInput:         return "zipf";
+    case nearlySortedInput: return "nearlySorted";
+    case allEqualInput:     return "allEqual";
+    default:                return "unknown";
+    }
+}
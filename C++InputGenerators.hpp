@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum inputDistribution
+ * @brief The kinds of input arrays generateInput can fill.
+ */
+enum inputDistribution {
+    ascendingInput,
+    descendingInput,
+    randomInput,
+    fewUniqueInput,
+    sawtoothInput,
+    organPipeInput,
+    zipfInput,
+    nearlySortedInput,
+    allEqualInput
+};
+
+// Number of distributions in inputDistribution
+constexpr int INPUT_DISTRIBUTION_COUNT = 9;
+
+// Seed used when none is given, so runs are reproducible by default
+constexpr std::uint64_t DEFAULT_INPUT_SEED = 0x5eed;
+
+// Distinct values in fewUniqueInput
+constexpr int FEW_UNIQUE_VALUES = 16;
+
+// nearlySortedInput makes one random swap per this many elements unless given a swap count
+constexpr int NEARLY_SORTED_SWAP_SPACING = 100;
+
+// Swap count that asks generateInput for the default of n / NEARLY_SORTED_SWAP_SPACING
+constexpr int DEFAULT_NEARLY_SORTED_SWAPS = -1;
+
+/**
+ * @brief Returns the index-th random number of the stream named by seed.
+ *
+ * A counter-based generator (a SplitMix64 finalizer over seed and index): any element
+ * can be computed on its own, so arrays can be filled in parallel in any order and the
+ * result depends only on the seed.
+ */
+std::uint64_t randomAt(std::uint64_t seed, std::uint64_t index);
+
+/**
+ * @brief Fills arr[0..n - 1] with the given distribution, splitting the work across threads.
+ *
+ * ascendingInput / descendingInput  0..n - 1 in order or reverse order.
+ * randomInput        A uniformly random permutation of 0..n - 1.
+ * fewUniqueInput     Uniform values from FEW_UNIQUE_VALUES distinct keys.
+ * sawtoothInput      About sqrt(n) ascending runs of about sqrt(n) elements each.
+ * organPipeInput     Ascending to the middle, then descending.
+ * zipfInput          Values in [0, n) where value v has probability close to proportional to 1 / (v + 1).
+ * nearlySortedInput  Ascending with swaps random pairs swapped.
+ * allEqualInput      Every element the same.
+ *
+ * @param arr          The array to fill.
+ * @param n            The number of elements in the array.
+ * @param distribution An inputDistribution.
+ * @param seed         Seed for the random distributions; the same seed gives the same array.
+ * @param threadCount  Number of threads including the caller, 0 uses every hardware thread.
+ * @param swaps        Random swaps in nearlySortedInput, DEFAULT_NEARLY_SORTED_SWAPS for n / NEARLY_SORTED_SWAP_SPACING.
+ */
+void generateInput(int arr[], int n, int distribution, std::uint64_t seed, int threadCount = 0, int swaps = DEFAULT_NEARLY_SORTED_SWAPS);
+
+/**
+ * @brief Converts an inputDistribution into a heading for printing.
+ */
+std::string inputDistributionToString(int distribution);
+
+/**
+ * @brief Converts an inputDistribution into the short name used on the command line and in reports.
+ */
+std::string inputDistributionToKey(int distribution);
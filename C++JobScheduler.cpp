@@ -0,0 +1,103 @@
+#include "C++JobScheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#define JOB_PINNING_AVAILABLE 1
+#include <pthread.h>
+#include <sched.h>
+#else
+#define JOB_PINNING_AVAILABLE 0
+#endif
+
+// The CPUs the process may run on, in order
+static std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#if JOB_PINNING_AVAILABLE
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+int availableCpuCount() {
+    std::vector<int> cpus = allowedCpus();
+    if (!cpus.empty()) {
+        return static_cast<int>(cpus.size());
+    }
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Pins the calling thread to cpu, silently leaving it unpinned where that is not possible
+static void pinCurrentThread(int cpu) {
+#if JOB_PINNING_AVAILABLE
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+#else
+    (void)cpu;
+#endif
+}
+
+void runJobs(int jobCount, int threadCount, const std::function<void(int)>& job) {
+    if (threadCount <= 0) {
+        threadCount = availableCpuCount();
+    }
+    threadCount = std::max(1, std::min(threadCount, jobCount));
+
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+    auto runGuarded = [&](int index) {
+        try {
+            job(index);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    };
+
+    // Serial mode: nothing else runs while a job is timed
+    if (threadCount == 1) {
+        for (int index = 0; index < jobCount; index++) {
+            runGuarded(index);
+        }
+    }
+    else {
+        std::atomic<int> nextJob{ 0 };
+        std::vector<int> cpus = allowedCpus();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threadCount; t++) {
+            workers.emplace_back([&, t]() {
+                // Pin before the first job so no job starts on one CPU and finishes on another
+                if (!cpus.empty()) {
+                    pinCurrentThread(cpus[t % cpus.size()]);
+                }
+                for (int index; (index = nextJob.fetch_add(1)) < jobCount;) {
+                    runGuarded(index);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
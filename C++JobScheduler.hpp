@@ -0,0 +1,24 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * @brief Runs job(0) through job(jobCount - 1), spreading them across pinned worker threads.
+ *
+ * Each worker is pinned to its own CPU from the process's affinity mask where the OS allows,
+ * so a job is not migrated between cores mid-measurement, and takes the next job index from a
+ * shared counter, so one long job does not hold back the rest. Lower indices start first, so
+ * callers should number their longest jobs first.
+ * A threadCount of 1 runs every job in order on the calling thread without creating any threads.
+ * If jobs throw, the remaining jobs still run and the first exception is rethrown afterwards.
+ *
+ * @param jobCount    Number of jobs.
+ * @param threadCount Number of worker threads, 0 uses every CPU the process may run on.
+ * @param job         Called once with each job index; must be safe to call concurrently.
+ */
+void runJobs(int jobCount, int threadCount, const std::function<void(int)>& job);
+
+/**
+ * @brief Number of CPUs the process may run on.
+ */
+int availableCpuCount();
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "C++GenericSortingAlgorithms.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Key-index sorts for ranges of records ordered by an int key.
+// Each record's key and position are packed into one 64-bit pair, and the pairs are sorted
+// as plain integers in a contiguous array, so the sort never touches the records themselves.
+// Pairs with equal keys keep their positions in order, so both sorts are stable.
+
+// Records gathered ahead of the current one when the permutation is applied
+constexpr std::ptrdiff_t PERMUTATION_PREFETCH_DISTANCE = 8;
+
+// Bytes per cache line, the stride of the prefetches over a record
+constexpr std::size_t PERMUTATION_CACHE_LINE_BYTES = 64;
+
+// Packs key and index so that ordering the pairs as unsigned integers orders by key, then by index
+inline std::uint64_t packKeyIndex(int key, std::uint32_t index) {
+    // Flipping the sign bit maps int order onto unsigned order
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key) ^ 0x80000000u) << 32) | index;
+}
+
+// Builds the packed pairs of [first, last) and sorts them
+template <typename RandomIt, typename KeyOf, typename CountPolicy>
+std::vector<std::uint64_t> sortedKeyIndexPairs(RandomIt first, RandomIt last, KeyOf& key, CountPolicy& counter) {
+    using difference = typename std::iterator_traits<RandomIt>::difference_type;
+    difference n = last - first;
+    if (static_cast<std::uint64_t>(n) > UINT32_MAX) {
+        throw std::length_error("Key-index sorts hold 32-bit indices and cannot sort more than 2^32 records");
+    }
+
+    std::vector<std::uint64_t> pairs(static_cast<std::size_t>(n));
+    for (difference i = 0; i < n; i++) {
+        pairs[i] = packKeyIndex(std::invoke(key, first[i]), static_cast<std::uint32_t>(i));
+    }
+    counter.movement(n); // Writing each pair
+
+    quickSort(pairs.begin(), pairs.end(), std::less<>(), identityProjection(), counter);
+    return pairs;
+}
+
+// Reorders [first, first + n) in place so that position i receives the record at indexAt(i).
+// Follows each cycle of the permutation: every step reads one record at random and writes it
+// into the slot the previous step just emptied, which is still in cache, so each record moves once.
+template <typename RandomIt, typename IndexAt, typename CountPolicy>
+void permuteByIndex(RandomIt first, std::ptrdiff_t n, IndexAt indexAt, CountPolicy& counter) {
+    std::vector<bool> placed(static_cast<std::size_t>(n));
+    for (std::ptrdiff_t start = 0; start < n; start++) {
+        if (placed[start] || indexAt(start) == static_cast<std::uint32_t>(start)) {
+            continue;
+        }
+
+        auto value = std::move(first[start]); // Movement
+        counter.movement();
+        std::ptrdiff_t hole = start;
+        while (true) {
+            std::ptrdiff_t source = indexAt(hole);
+            placed[hole] = true;
+            if (source == start) {
+                first[hole] = std::move(value); // Movement
+                counter.movement();
+                break;
+            }
+            first[hole] = std::move(first[source]); // Movement
+            counter.movement();
+            hole = source;
+        }
+    }
+}
+
+// Reorders [first, first + n) so that position i receives the record at indexAt(i), through scratch.
+// The records are gathered into scratch with sequential writes, prefetching every cache line of the
+// record PERMUTATION_PREFETCH_DISTANCE ahead so the random reads overlap, then moved back in one stream.
+template <typename RandomIt, typename IndexAt, typename CountPolicy>
+void gatherByIndex(RandomIt first, std::ptrdiff_t n, IndexAt indexAt, typename std::iterator_traits<RandomIt>::value_type scratch[], CountPolicy& counter) {
+    using value = typename std::iterator_traits<RandomIt>::value_type;
+    if (n <= 0) {
+        return;
+    }
+
+    for (std::ptrdiff_t i = 0; i < n; i++) {
+        if (i + PERMUTATION_PREFETCH_DISTANCE < n) {
+            const char* ahead = reinterpret_cast<const char*>(std::addressof(first[indexAt(i + PERMUTATION_PREFETCH_DISTANCE)]));
+            for (std::size_t offset = 0; offset < sizeof(value); offset += PERMUTATION_CACHE_LINE_BYTES) {
+                __builtin_prefetch(ahead + offset);
+            }
+        }
+        scratch[i] = std::move(first[indexAt(i)]);
+    }
+
+    std::move(scratch, scratch + n, first);
+    counter.movement(2 * n); // Each record moves out and back once
+}
+
+/**
+ * @brief Returns the permutation that sorts a range of records by key, leaving the records untouched.
+ *
+ * Stable. Uses 12 bytes of scratch per record, independent of the record size.
+ *
+ * @param first      Iterator to the first record of the range.
+ * @param last       Iterator one past the last record of the range.
+ * @param key        Projection giving each record's int key, such as a pointer to member.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ * @return index where first[index[0]], first[index[1]], ... are in key order.
+ * @throws std::length_error if the range has more than 2^32 records.
+ */
+template <typename RandomIt, typename KeyOf, typename CountPolicy = noCountingPolicy>
+std::vector<std::uint32_t> argSort(RandomIt first, RandomIt last, KeyOf key, CountPolicy counter = {}) {
+    std::vector<std::uint64_t> pairs = sortedKeyIndexPairs(first, last, key, counter);
+
+    std::vector<std::uint32_t> index(pairs.size());
+    for (std::size_t i = 0; i < pairs.size(); i++) {
+        index[i] = static_cast<std::uint32_t>(pairs[i]); // The low half of a pair is its index
+    }
+    counter.movement(pairs.size());
+    return index;
+}
+
+/**
+ * @brief Reorders a range of records in place so that position i receives the record at index[i].
+ *
+ * Follows the cycles of the permutation, so each record moves once and only a bit per record of scratch is used.
+ *
+ * @param first      Iterator to the first record of the range.
+ * @param last       Iterator one past the last record of the range.
+ * @param index      A permutation of 0..(last - first) - 1, such as the result of argSort.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename RandomIt, typename CountPolicy = noCountingPolicy>
+void applyPermutation(RandomIt first, RandomIt last, const std::vector<std::uint32_t>& index, CountPolicy counter = {}) {
+    permuteByIndex(first, last - first, [&](std::ptrdiff_t i) { return index[i]; }, counter);
+}
+
+/**
+ * @brief Sorts a range of records by key through packed (key, index) pairs.
+ *
+ * Stable. The pairs are sorted in a contiguous array of 8 bytes per record, and the records
+ * are then permuted once at the end, so each record moves O(1) times however large it is,
+ * where sorting the records directly moves them O(n log n) times.
+ *
+ * Without scratch the permutation follows its cycles in place, one random read per record.
+ * With scratch it is one gather pass with prefetched reads and sequential writes, followed by a
+ * sequential copy back, which is faster when the same buffer is reused across sorts.
+ *
+ * @param first      Iterator to the first record of the range.
+ * @param last       Iterator one past the last record of the range.
+ * @param key        Projection giving each record's int key, such as a pointer to member.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ * @param scratch    Optional buffer of at least last - first records, nullptr to permute in place.
+ * @throws std::length_error if the range has more than 2^32 records.
+ */
+template <typename RandomIt, typename KeyOf, typename CountPolicy = noCountingPolicy>
+void pairSort(RandomIt first, RandomIt last, KeyOf key, CountPolicy counter = {},
+    typename std::iterator_traits<RandomIt>::value_type scratch[] = nullptr) {
+    std::vector<std::uint64_t> pairs = sortedKeyIndexPairs(first, last, key, counter);
+    auto indexAt = [&](std::ptrdiff_t i) { return static_cast<std::uint32_t>(pairs[i]); }; // The low half of a pair is its index
+
+    if (scratch == nullptr) {
+        permuteByIndex(first, last - first, indexAt, counter);
+    }
+    else {
+        gatherByIndex(first, last - first, indexAt, scratch, counter);
+    }
+}
@@ -0,0 +1,229 @@
+#include "C++MappedFile.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MAPPED_FILE_MMAP 0
+#endif
+
+// The file format is little-endian, so big-endian hosts swap every int on the way in and out
+static bool hostIsLittleEndian() {
+    const std::uint16_t probe = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 1;
+}
+
+static void swapByteOrder(int arr[], std::size_t n) {
+    if (hostIsLittleEndian()) {
+        return;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        std::uint32_t value;
+        std::memcpy(&value, &arr[i], sizeof(value));
+        value = (value >> 24) | ((value >> 8) & 0xff00u) | ((value << 8) & 0xff0000u) | (value << 24);
+        std::memcpy(&arr[i], &value, sizeof(value));
+    }
+}
+
+#if MAPPED_FILE_MMAP
+
+// Opens path and returns its descriptor and status, throwing if either fails
+static int openDescriptor(const std::string& path, int flags, struct stat& status) {
+    int descriptor = ::open(path.c_str(), flags, 0644);
+    if (descriptor < 0) {
+        throw std::runtime_error("mappedIntArray: cannot open " + path);
+    }
+
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("mappedIntArray: cannot stat " + path);
+    }
+    return descriptor;
+}
+
+// Maps a descriptor and faults every page in, so the mapping time covers the actual I/O
+static void* mapDescriptor(int descriptor, std::size_t bytes, int flags, const std::string& path) {
+    if (bytes == 0) {
+        return nullptr;
+    }
+
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, descriptor, 0);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("mappedIntArray: cannot map " + path);
+    }
+
+#ifndef MAP_POPULATE
+    volatile const char* pages = static_cast<const char*>(address);
+    for (std::size_t offset = 0; offset < bytes; offset += 4096) {
+        (void)pages[offset];
+    }
+#endif
+    return address;
+}
+
+mappedIntArray::mappedIntArray(const std::string& inputPath) {
+    struct stat status;
+    int descriptor = openDescriptor(inputPath, O_RDONLY, status);
+    try {
+        count = static_cast<std::size_t>(status.st_size) / sizeof(int);
+        bytes = count * sizeof(int); // A trailing partial int is ignored
+        mapping = static_cast<int*>(mapDescriptor(descriptor, bytes, MAP_PRIVATE, inputPath));
+        elements = mapping;
+    }
+    catch (...) {
+        ::close(descriptor);
+        throw;
+    }
+    ::close(descriptor); // The mapping keeps the file alive
+
+    swapByteOrder(elements, count);
+}
+
+mappedIntArray::mappedIntArray(const std::string& inputPath, const std::string& outputPath) : outputPath(outputPath), shared(true) {
+    mappedIntArray input(inputPath);
+    count = input.count;
+    bytes = input.bytes;
+
+    // The output is opened without O_TRUNC, since truncating the input itself would zero the private mapping's pages
+    struct stat inputStatus, outputStatus;
+    if (::stat(inputPath.c_str(), &inputStatus) != 0) {
+        throw std::runtime_error("mappedIntArray: cannot stat " + inputPath);
+    }
+    int descriptor = openDescriptor(outputPath, O_RDWR | O_CREAT, outputStatus);
+    try {
+        if (outputStatus.st_dev == inputStatus.st_dev && outputStatus.st_ino == inputStatus.st_ino) {
+            throw std::invalid_argument("mappedIntArray: the output " + outputPath + " is the input file");
+        }
+        if (::ftruncate(descriptor, 0) != 0 || ::ftruncate(descriptor, static_cast<off_t>(bytes)) != 0) {
+            throw std::runtime_error("mappedIntArray: cannot size " + outputPath);
+        }
+        mapping = static_cast<int*>(mapDescriptor(descriptor, bytes, MAP_SHARED, outputPath));
+    }
+    catch (...) {
+        ::close(descriptor);
+        throw;
+    }
+    ::close(descriptor);
+
+    // A shared mapping must only ever hold little-endian ints, or a writeback could store native ones,
+    // so big-endian hosts sort a heap copy and flush() stores it swapped into the mapping
+    if (count > 0) {
+        elements = hostIsLittleEndian() ? mapping : new int[count];
+        std::memcpy(elements, input.elements, bytes);
+    }
+}
+
+mappedIntArray::~mappedIntArray() {
+    if (elements == nullptr) {
+        return;
+    }
+    try {
+        flush();
+    }
+    catch (...) {
+        // Destructors cannot report the failure, call flush() first to see it
+    }
+    if (elements != mapping) {
+        delete[] elements;
+    }
+    ::munmap(mapping, bytes);
+}
+
+void mappedIntArray::flush() {
+    if (!shared || elements == nullptr) {
+        return;
+    }
+
+    if (elements != mapping) {
+        std::memcpy(mapping, elements, bytes);
+        swapByteOrder(mapping, count);
+    }
+    if (::msync(mapping, bytes, MS_SYNC) != 0) {
+        throw std::runtime_error("mappedIntArray: cannot write " + outputPath);
+    }
+}
+
+#else
+
+// Without mmap the file is read into a heap buffer, and output mappings are written back on flush
+
+mappedIntArray::mappedIntArray(const std::string& inputPath) {
+    std::FILE* file = std::fopen(inputPath.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("mappedIntArray: cannot open " + inputPath);
+    }
+
+    std::vector<int> contents;
+    int buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, sizeof(int), 4096, file)) > 0) {
+        contents.insert(contents.end(), buffer, buffer + read);
+    }
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (failed) {
+        throw std::runtime_error("mappedIntArray: cannot read " + inputPath);
+    }
+
+    count = contents.size();
+    bytes = count * sizeof(int);
+    if (count > 0) {
+        elements = new int[count];
+        std::memcpy(elements, contents.data(), bytes);
+    }
+    swapByteOrder(elements, count);
+}
+
+mappedIntArray::mappedIntArray(const std::string& inputPath, const std::string& outputPath) : mappedIntArray(inputPath) {
+    std::error_code ignored;
+    if (std::filesystem::equivalent(inputPath, outputPath, ignored)) {
+        throw std::invalid_argument("mappedIntArray: the output " + outputPath + " is the input file");
+    }
+    this->outputPath = outputPath;
+    shared = true;
+    flush(); // Create the output right away, like the mmap version does
+}
+
+mappedIntArray::~mappedIntArray() {
+    try {
+        flush();
+    }
+    catch (...) {
+        // Destructors cannot report the failure, call flush() first to see it
+    }
+    delete[] elements;
+}
+
+void mappedIntArray::flush() {
+    if (!shared) {
+        return;
+    }
+
+    std::FILE* file = std::fopen(outputPath.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("mappedIntArray: cannot open " + outputPath);
+    }
+    swapByteOrder(elements, count);
+    bool failed = count > 0 && std::fwrite(elements, sizeof(int), count, file) != count;
+    swapByteOrder(elements, count);
+    failed = std::fclose(file) != 0 || failed;
+    if (failed) {
+        throw std::runtime_error("mappedIntArray: cannot write " + outputPath);
+    }
+}
+
+#endif
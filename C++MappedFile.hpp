@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class mappedIntArray
+ * @brief A file of raw little-endian ints mapped into memory as an int array.
+ *
+ * Opened with one path, the input is mapped copy-on-write: the array can be sorted
+ * freely and the file is never modified. Opened with an output path, the output file
+ * is created with a copy of the input and mapped shared, so sorting the array sorts
+ * the output file in place. Big-endian hosts sort a native copy of an output mapping
+ * instead, which flush() stores into the file swapped to little-endian.
+ * On hosts without mmap the file is read into memory instead.
+ */
+class mappedIntArray {
+public:
+    /**
+     * @brief Maps inputPath as a private copy-on-write array.
+     *
+     * @param inputPath  File of raw little-endian ints.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit mappedIntArray(const std::string& inputPath);
+
+    /**
+     * @brief Copies inputPath into outputPath and maps the output for sorting in place.
+     *
+     * @param inputPath  File of raw little-endian ints.
+     * @param outputPath File that receives the data; it is created or truncated, and must not be
+     *                   the input file under any name, since truncating it would lose the data.
+     * @throws std::runtime_error if either file cannot be opened, sized, or mapped.
+     * @throws std::invalid_argument if outputPath names the same file as inputPath.
+     */
+    mappedIntArray(const std::string& inputPath, const std::string& outputPath);
+
+    /**
+     * @brief Flushes an output mapping and unmaps the file.
+     */
+    ~mappedIntArray();
+
+    mappedIntArray(const mappedIntArray&) = delete;
+    mappedIntArray& operator=(const mappedIntArray&) = delete;
+
+    int* data() { return elements; }
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Writes an output mapping back to its file; a no-op for private mappings.
+     *
+     * @throws std::runtime_error if the data cannot be written.
+     */
+    void flush();
+
+private:
+    int* elements = nullptr;
+    int* mapping = nullptr; // The mapped file, which elements points into unless it is a native copy
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+    std::string outputPath;
+    bool shared = false;
+};
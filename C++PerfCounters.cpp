@@ -0,0 +1,131 @@
+#include "C++PerfCounters.hpp"
+#include <cstdint>
+
+#if defined(__linux__)
+#define PERF_COUNTERS_AVAILABLE 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#else
+#define PERF_COUNTERS_AVAILABLE 0
+#endif
+
+#if PERF_COUNTERS_AVAILABLE
+
+// Opens one user-space counter for the calling thread, or returns -1 if the host refuses it
+static int openCounter(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    long descriptor = ::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+    return descriptor < 0 ? -1 : static_cast<int>(descriptor);
+}
+
+// Cache events are encoded as cache id | operation << 8 | result << 16
+static std::uint64_t cacheReadMiss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+perfCounters::perfCounters() {
+    descriptors[counterCycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    descriptors[counterInstructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    descriptors[counterL1dMisses] = openCounter(PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_L1D));
+    descriptors[counterLlcMisses] = openCounter(PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_LL));
+    descriptors[counterBranchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+}
+
+perfCounters::~perfCounters() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+    }
+}
+
+void perfCounters::start() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            ::ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void perfCounters::stop() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            ::ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+void perfCounters::read(unsigned long long values[]) const {
+    for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+        values[counter] = 0;
+
+        // value, time enabled, time running
+        std::uint64_t sample[3];
+        if (descriptors[counter] < 0 || ::read(descriptors[counter], sample, sizeof(sample)) != static_cast<ssize_t>(sizeof(sample))) {
+            continue;
+        }
+
+        // Scale up a counter that only ran for part of the time because the kernel multiplexed it
+        if (sample[2] > 0 && sample[2] < sample[1]) {
+            values[counter] = static_cast<unsigned long long>(static_cast<double>(sample[0]) * sample[1] / sample[2]);
+        }
+        else {
+            values[counter] = sample[0];
+        }
+    }
+}
+
+#else
+
+perfCounters::perfCounters() {
+    for (int& descriptor : descriptors) {
+        descriptor = -1;
+    }
+}
+
+perfCounters::~perfCounters() {}
+
+void perfCounters::start() {}
+
+void perfCounters::stop() {}
+
+void perfCounters::read(unsigned long long values[]) const {
+    for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+        values[counter] = 0;
+    }
+}
+
+#endif
+
+bool perfCounters::anyAvailable() const {
+    for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+        if (available(counter)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* hardwareCounterName(int counter) {
+    switch (counter) {
+    case counterCycles:       return "Cycles";
+    case counterInstructions: return "Instructions";
+    case counterL1dMisses:    return "L1D Misses";
+    case counterLlcMisses:    return "LLC Misses";
+    case counterBranchMisses: return "Branch Misses";
+    default:                  return "Unknown";
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * @enum hardwareCounter
+ * @brief The hardware events counted by perfCounters, in the order their values are read.
+ */
+enum hardwareCounter {
+    counterCycles,
+    counterInstructions,
+    counterL1dMisses,
+    counterLlcMisses,
+    counterBranchMisses,
+    HARDWARE_COUNTER_COUNT
+};
+
+/**
+ * @class perfCounters
+ * @brief User-space hardware performance counters around a region of code.
+ *
+ * Each event is opened on its own through perf_event_open, so an event the CPU or
+ * kernel does not support (common in virtual machines) is simply unavailable while
+ * the rest are still counted. Counts are scaled when the kernel multiplexes events.
+ * Only the constructing thread is counted, so the parallel sorts' worker threads are not.
+ * Construction never fails: on hosts without perf_event_open, or when permission is
+ * denied, every event reports unavailable and read() returns zeros.
+ */
+class perfCounters {
+public:
+    perfCounters();
+    ~perfCounters();
+
+    perfCounters(const perfCounters&) = delete;
+    perfCounters& operator=(const perfCounters&) = delete;
+
+    /**
+     * @brief Whether counter could be opened on this host.
+     */
+    bool available(int counter) const { return descriptors[counter] >= 0; }
+
+    /**
+     * @brief Whether any counter could be opened on this host.
+     */
+    bool anyAvailable() const;
+
+    /**
+     * @brief Zeroes and starts every available counter.
+     */
+    void start();
+
+    /**
+     * @brief Stops every available counter.
+     */
+    void stop();
+
+    /**
+     * @brief Reads the counts since the last start(), indexed by hardwareCounter.
+     *
+     * @param values  Receives HARDWARE_COUNTER_COUNT counts; unavailable counters read 0.
+     */
+    void read(unsigned long long values[]) const;
+
+private:
+    int descriptors[HARDWARE_COUNTER_COUNT];
+};
+
+/**
+ * @brief Converts a hardwareCounter into a column heading for printing.
+ */
+const char* hardwareCounterName(int counter);
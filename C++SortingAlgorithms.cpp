@@ -1,75 +1,193 @@
 #include "C++SortingAlgorithms.hpp"
+#include "C++SortingNetworks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
 using namespace std;
 
 // Movement: Any time an element in the array is written/modified
 // Comparison: Evaluation between two elements to determine their order
 
-void insertionSort(int arr[], int n, sortResults& sortResult) {
+template <typename CountPolicy>
+void insertionSort(int arr[], int n, CountPolicy counter) {
     for (int i = 1; i < n; i++) {
         int key = arr[i];
         int j = i - 1;
         bool madeComparison = false;
 
         while (j >= 0 && arr[j] > key) {
-            sortResult.comparisons++; // arr[j] > key is a comparison
+            counter.comparison(); // arr[j] > key is a comparison
             madeComparison = true;
             arr[j + 1] = arr[j]; // Movement
-            sortResult.movements++;
+            counter.movement();
             j--;
         }
 
         if (madeComparison || j >= 0) {
-            sortResult.comparisons++; // Final comparison to break the loop
+            counter.comparison(); // Final comparison to break the loop
         }
 
         if (arr[j + 1] != key) {
             arr[j + 1] = key; // Movement
-            sortResult.movements++;
+            counter.movement();
         }
     }
 }
 
-int partition(int arr[], int low, int high, sortResults& sortResult) {
-    int pivot = arr[(high + low) / 2];
+template <typename CountPolicy>
+int partition(int arr[], int low, int high, CountPolicy counter) {
+    int mid = low + (high - low) / 2;
+    if (mid != high) {
+        swap(arr[mid], arr[high]); // Move the middle pivot to the end, counts as 2 movements
+        counter.movement(2);
+    }
+
+    int pivot = arr[high];
     int i = low - 1;
 
     for (int j = low; j < high; j++) {
-        sortResult.comparisons++; // arr[j] < pivot is a comparison
+        counter.comparison(); // arr[j] < pivot is a comparison
         if (arr[j] < pivot) {
             i++;
             swap(arr[i], arr[j]); // Swap counts as 2 movements
-            sortResult.movements += 2;
+            counter.movement(2);
         }
     }
 
     swap(arr[i + 1], arr[high]); // Swap counts as 2 movements
-    sortResult.movements += 2;
+    counter.movement(2);
     return i + 1;
 }
 
-void quickSort(int arr[], int low, int high, sortResults& sortResult) {
+template <typename CountPolicy>
+void quickSort(int arr[], int low, int high, CountPolicy counter) {
     if (low < high) {
-        int pi = partition(arr, low, high, sortResult);
-        quickSort(arr, low, pi - 1, sortResult);
-        quickSort(arr, pi + 1, high, sortResult);
+        int pi = partition(arr, low, high, counter);
+        quickSort(arr, low, pi - 1, counter);
+        quickSort(arr, pi + 1, high, counter);
+    }
+}
+
+// Bentley-McIlroy three-way partition around the middle element. Keys equal to the pivot are
+// parked at both ends while scanning and swapped into the middle afterwards, leaving
+// arr[low..lessEnd] < pivot, arr[lessEnd + 1..greaterStart - 1] == pivot, and arr[greaterStart..high] > pivot
+template <typename CountPolicy>
+void threeWayPartition(int arr[], int low, int high, int& lessEnd, int& greaterStart, CountPolicy counter) {
+    int mid = low + (high - low) / 2;
+    if (mid != low) {
+        swap(arr[mid], arr[low]); // Move the middle pivot to the front, counts as 2 movements
+        counter.movement(2);
+    }
+
+    int pivot = arr[low];
+    int i = low, j = high + 1;
+    int p = low, q = high + 1; // arr[low..p] and arr[q..high] hold keys equal to the pivot
+
+    while (true) {
+        do {
+            i++;
+            counter.comparison(); // arr[i] < pivot is a comparison
+        } while (arr[i] < pivot && i != high);
+        do {
+            j--;
+            counter.comparison(); // pivot < arr[j] is a comparison
+        } while (pivot < arr[j] && j != low);
+
+        // The scans met on a key equal to the pivot, which joins the left end
+        if (i == j) {
+            counter.comparison();
+            if (arr[i] == pivot) {
+                swap(arr[++p], arr[i]);
+                counter.movement(2);
+            }
+        }
+        if (i >= j) {
+            break;
+        }
+
+        swap(arr[i], arr[j]); // Swap counts as 2 movements
+        counter.movement(2);
+
+        // Park keys equal to the pivot at the ends, out of the way of the scans
+        counter.comparison();
+        if (arr[i] == pivot) {
+            swap(arr[++p], arr[i]);
+            counter.movement(2);
+        }
+        counter.comparison();
+        if (arr[j] == pivot) {
+            swap(arr[--q], arr[j]);
+            counter.movement(2);
+        }
+    }
+
+    // Swap the parked equal keys from both ends into the middle
+    i = j + 1;
+    for (int k = low; k <= p; k++) {
+        swap(arr[k], arr[j--]);
+        counter.movement(2);
+    }
+    for (int k = high; k >= q; k--) {
+        swap(arr[k], arr[i++]);
+        counter.movement(2);
+    }
+
+    lessEnd = j;
+    greaterStart = i;
+}
+
+template <typename CountPolicy>
+void threeWayQuickSort(int arr[], int low, int high, CountPolicy counter) {
+    while (low < high) {
+        int lessEnd, greaterStart;
+        threeWayPartition(arr, low, high, lessEnd, greaterStart, counter);
+
+        // Keys equal to the pivot are in place; recurse into the smaller side and loop on the larger
+        if (lessEnd - low < high - greaterStart) {
+            threeWayQuickSort(arr, low, lessEnd, counter);
+            low = greaterStart;
+        }
+        else {
+            threeWayQuickSort(arr, greaterStart, high, counter);
+            high = lessEnd;
+        }
+    }
+}
+
+template <typename CountPolicy>
+void quickSort(int arr[], int low, int high, bool threeWay, CountPolicy counter) {
+    if (threeWay) {
+        threeWayQuickSort(arr, low, high, counter);
+    }
+    else {
+        quickSort(arr, low, high, counter);
     }
 }
 
-void heapify(int arr[], int n, int i, sortResults& sortResult) {
+template <typename CountPolicy>
+void heapify(int arr[], int n, int i, CountPolicy counter) {
     int largest = i;
     int left = 2 * i + 1;
     int right = 2 * i + 2;
 
     if (left < n) {
-        sortResult.comparisons++; // Comparison between left and largest
+        counter.comparison(); // Comparison between left and largest
         if (arr[left] > arr[largest]) {
             largest = left;
         }
     }
 
     if (right < n) {
-        sortResult.comparisons++; // Comparison between right and largest
+        counter.comparison(); // Comparison between right and largest
         if (arr[right] > arr[largest]) {
             largest = right;
         }
@@ -77,24 +195,250 @@ void heapify(int arr[], int n, int i, sortResults& sortResult) {
 
     if (largest != i) {
         swap(arr[i], arr[largest]); // Swap counts as 2 movements
-        sortResult.movements += 2;
-        heapify(arr, n, largest, sortResult); // Recursively heapify the affected subtree
+        counter.movement(2);
+        heapify(arr, n, largest, counter); // Recursively heapify the affected subtree
     }
 }
 
-void heapSort(int arr[], int n, sortResults& sortResult) {
+template <typename CountPolicy>
+void heapSort(int arr[], int n, CountPolicy counter) {
     for (int i = n / 2 - 1; i >= 0; i--) {
-        heapify(arr, n, i, sortResult);
+        heapify(arr, n, i, counter);
+    }
+
+    for (int i = n - 1; i > 0; i--) {
+        swap(arr[0], arr[i]); // Swap counts as 2 movements
+        counter.movement(2);
+        heapify(arr, i, 0, counter);
+    }
+}
+
+// Gathers the k smallest elements of arr[0..n - 1] into a max-heap in arr[0..k - 1], so arr[0] is the k-th smallest.
+// Every later element costs one comparison against the heap's root, and a sift only when it is smaller.
+template <typename CountPolicy>
+void heapSelect(int arr[], int n, int k, CountPolicy counter) {
+    for (int i = k / 2 - 1; i >= 0; i--) {
+        heapify(arr, k, i, counter);
+    }
+
+    for (int i = k; i < n; i++) {
+        counter.comparison(); // arr[i] < arr[0] is a comparison
+        if (arr[i] < arr[0]) {
+            swap(arr[0], arr[i]); // Swap counts as 2 movements
+            counter.movement(2);
+            heapify(arr, k, 0, counter);
+        }
+    }
+}
+
+template <typename CountPolicy>
+void nthElement(int arr[], int n, int k, CountPolicy counter) {
+    if (k < 0 || k >= n) {
+        return;
+    }
+
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2; // 2 * floor(log2(n))
+    }
+
+    int low = 0, high = n - 1;
+    while (low < high) {
+        if (depthLimit-- == 0) {
+            // Partitions keep landing far from k (for example on many duplicates), so select with a heap instead
+            heapSelect(arr + low, high - low + 1, k - low + 1, counter);
+            swap(arr[low], arr[k]); // Swap counts as 2 movements
+            counter.movement(2);
+            return;
+        }
+
+        // Only the side holding k is partitioned further
+        int pi = partition(arr, low, high, counter);
+        if (pi == k) {
+            return;
+        }
+        if (k < pi) {
+            high = pi - 1;
+        }
+        else {
+            low = pi + 1;
+        }
+    }
+}
+
+template <typename CountPolicy>
+void partialSort(int arr[], int n, int k, CountPolicy counter) {
+    k = min(max(k, 0), n);
+    heapSelect(arr, n, k, counter);
+
+    // Sort the heap in place, the second half of Heap Sort
+    for (int i = k - 1; i > 0; i--) {
+        swap(arr[0], arr[i]); // Swap counts as 2 movements
+        counter.movement(2);
+        heapify(arr, i, 0, counter);
+    }
+}
+
+streamingTopK::streamingTopK(int k) : k(max(k, 0)) {
+    heap.reserve(this->k);
+}
+
+template <typename CountPolicy>
+void streamingTopK::push(int value, CountPolicy counter) {
+    if (static_cast<int>(heap.size()) < k) {
+        heap.push_back(value); // Movement
+        counter.movement();
+
+        // Heapify once full rather than sifting every value up while filling
+        if (static_cast<int>(heap.size()) == k) {
+            for (int i = k / 2 - 1; i >= 0; i--) {
+                heapify(heap.data(), k, i, counter);
+            }
+        }
+        return;
+    }
+
+    counter.comparison(); // value < heap[0] is a comparison
+    if (k > 0 && value < heap[0]) {
+        heap[0] = value; // Movement, the largest kept value is dropped
+        counter.movement();
+        heapify(heap.data(), k, 0, counter);
+    }
+}
+
+void streamingTopK::push(int value, sortResults& sortResult) {
+    push(value, countingPolicy{ sortResult });
+}
+
+void streamingTopK::push(int value) {
+    push(value, noCountingPolicy{});
+}
+
+template <typename CountPolicy>
+std::vector<int> streamingTopK::sorted(CountPolicy counter) const {
+    std::vector<int> values = heap;
+    heapSort(values.data(), static_cast<int>(values.size()), counter);
+    return values;
+}
+
+std::vector<int> streamingTopK::sorted() const {
+    return sorted(noCountingPolicy{});
+}
+
+// Alignment used by bottomUpHeapSort to keep each group of siblings within one cache line
+constexpr int CACHE_LINE_BYTES = 64;
+
+// Bottom-up sift-down of arr[root] in a d-ary heap of n elements
+// Moves a hole from the root down to a leaf, pulling the largest child up at each level
+// without comparing it against the sifted value, then sifts the value up from the leaf.
+// The sifted value is usually small, so the climb is short and each level costs about
+// arity - 1 comparisons instead of the arity comparisons of a top-down sift.
+// Arity is an int or a std::integral_constant, so the common arities divide by a constant
+template <typename Arity, typename CountPolicy>
+void bottomUpSiftDown(int arr[], int n, int root, Arity arity, CountPolicy counter) {
+    int value = arr[root];
+
+    // Every level but the last has a full set of children, so the inner loop has a fixed trip count
+    int hole = root;
+    int first = hole * arity + 1;
+    for (; first + static_cast<int>(arity) <= n; first = hole * arity + 1) {
+        // The next level's children are all grandchildren of the hole and sit together,
+        // so fetch them while this level is compared
+        if (first < n / arity) {
+            __builtin_prefetch(arr + first * arity + 1);
+        }
+        int largest = first;
+        for (int offset = 1; offset < static_cast<int>(arity); offset++) {
+            counter.comparison(); // Compare arr[first + offset] and arr[largest]
+            // Branch-free select, random children make the branch unpredictable
+            largest += (first + offset - largest) * (arr[first + offset] > arr[largest]);
+        }
+        arr[hole] = arr[largest]; // Movement
+        counter.movement();
+        hole = largest;
+    }
+    if (first < n) {
+        int largest = first;
+        for (int child = first + 1; child < n; child++) {
+            counter.comparison(); // Compare arr[child] and arr[largest]
+            largest = arr[child] > arr[largest] ? child : largest;
+        }
+        arr[hole] = arr[largest]; // Movement
+        counter.movement();
+        hole = largest;
+    }
+
+    while (hole != root) {
+        int parent = (hole - 1) / arity;
+        counter.comparison(); // Compare value and arr[parent]
+        if (value <= arr[parent]) {
+            break;
+        }
+        arr[hole] = arr[parent]; // Movement
+        counter.movement();
+        hole = parent;
+    }
+    arr[hole] = value; // Movement
+    counter.movement();
+}
+
+// Iterative bottom-up heap sort over a d-ary heap stored in arr[0..n - 1]
+template <typename Arity, typename CountPolicy>
+void bottomUpHeapSortRange(int arr[], int n, Arity arity, CountPolicy counter) {
+    for (int i = (n - 2) / arity; i >= 0 && n > 1; i--) {
+        bottomUpSiftDown(arr, n, i, arity, counter);
     }
 
     for (int i = n - 1; i > 0; i--) {
         swap(arr[0], arr[i]); // Swap counts as 2 movements
-        sortResult.movements += 2;
-        heapify(arr, i, 0, sortResult);
+        counter.movement(2);
+        bottomUpSiftDown(arr, i, 0, arity, counter);
+    }
+}
+
+// Runs bottomUpHeapSortRange with the arity as a compile-time constant when it is a power of two up to 16
+template <typename CountPolicy>
+void bottomUpHeapSortRange(int arr[], int n, int arity, CountPolicy counter) {
+    switch (arity) {
+    case 2:  bottomUpHeapSortRange(arr, n, std::integral_constant<int, 2>(), counter); break;
+    case 4:  bottomUpHeapSortRange(arr, n, std::integral_constant<int, 4>(), counter); break;
+    case 8:  bottomUpHeapSortRange(arr, n, std::integral_constant<int, 8>(), counter); break;
+    case 16: bottomUpHeapSortRange(arr, n, std::integral_constant<int, 16>(), counter); break;
+    default: bottomUpHeapSortRange<int>(arr, n, arity, counter); break;
+    }
+}
+
+template <typename CountPolicy>
+void bottomUpHeapSort(int arr[], int n, int arity, bool alignSiblings, CountPolicy counter) {
+    if (!alignSiblings || n < 2) {
+        bottomUpHeapSortRange(arr, n, arity, counter);
+        return;
     }
+
+    // Children of heap node i live at i * arity + 1, so starting the heap arity - 1 slots
+    // past a cache-line boundary puts every group of siblings at a multiple of arity ints
+    constexpr int lineInts = CACHE_LINE_BYTES / sizeof(int);
+    int* buffer = new int[n + arity - 1 + lineInts];
+    int* aligned = buffer + (lineInts - reinterpret_cast<std::uintptr_t>(buffer) / sizeof(int) % lineInts) % lineInts;
+    int* heap = aligned + arity - 1;
+
+    std::copy(arr, arr + n, heap);
+    counter.movement(n);
+
+    bottomUpHeapSortRange(heap, n, arity, counter);
+
+    std::copy(heap, heap + n, arr);
+    counter.movement(n);
+    delete[] buffer;
+}
+
+template <typename CountPolicy>
+void bottomUpHeapSort(int arr[], int n, CountPolicy counter) {
+    bottomUpHeapSortRange(arr, n, std::integral_constant<int, 2>(), counter);
 }
 
-void merge(int arr[], int left, int mid, int right, sortResults& sortResult) {
+template <typename CountPolicy>
+void merge(int arr[], int left, int mid, int right, CountPolicy counter) {
     int n1 = mid - left + 1;
     int n2 = right - mid;
 
@@ -103,25 +447,25 @@ void merge(int arr[], int left, int mid, int right, sortResults& sortResult) {
 
     for (int i = 0; i < n1; i++) {
         L[i] = arr[left + i]; // Movement
-        sortResult.movements++;
+        counter.movement();
     }
 
     for (int j = 0; j < n2; j++) {
         R[j] = arr[mid + 1 + j]; // Movement
-        sortResult.movements++;
+        counter.movement();
     }
 
     int i = 0, j = 0, k = left;
     while (i < n1 && j < n2) {
-        sortResult.comparisons++; // Compare L[i] and R[j]
+        counter.comparison(); // Compare L[i] and R[j]
         if (L[i] <= R[j]) {
             arr[k] = L[i]; // Movement
-            sortResult.movements++;
+            counter.movement();
             i++;
         }
         else {
             arr[k] = R[j]; // Movement
-            sortResult.movements++;
+            counter.movement();
             j++;
         }
         k++;
@@ -129,14 +473,14 @@ void merge(int arr[], int left, int mid, int right, sortResults& sortResult) {
 
     while (i < n1) {
         arr[k] = L[i]; // Movement
-        sortResult.movements++;
+        counter.movement();
         i++;
         k++;
     }
 
     while (j < n2) {
         arr[k] = R[j]; // Movement
-        sortResult.movements++;
+        counter.movement();
         j++;
         k++;
     }
@@ -145,11 +489,1813 @@ void merge(int arr[], int left, int mid, int right, sortResults& sortResult) {
     delete[] R; // Clean up dynamic memory
 }
 
-void mergeSort(int arr[], int left, int right, sortResults& sortResult) {
+template <typename CountPolicy>
+void mergeSort(int arr[], int left, int right, CountPolicy counter) {
+    if (left < right) {
+        int mid = left + (right - left) / 2;
+        mergeSort(arr, left, mid, counter);
+        mergeSort(arr, mid + 1, right, counter);
+        merge(arr, left, mid, right, counter);
+    }
+}
+
+// Merges the sorted runs src[left1..right1] and src[left2..right2] into dst starting at dst[k]
+template <typename CountPolicy>
+void mergeRunsInto(const int src[], int left1, int right1, int left2, int right2, int dst[], int k, CountPolicy counter) {
+    int i = left1, j = left2;
+    while (i <= right1 && j <= right2) {
+        counter.comparison(); // Compare src[i] and src[j]
+        if (src[i] <= src[j]) {
+            dst[k++] = src[i++]; // Movement
+        }
+        else {
+            dst[k++] = src[j++]; // Movement
+        }
+        counter.movement();
+    }
+
+    while (i <= right1) {
+        dst[k++] = src[i++]; // Movement
+        counter.movement();
+    }
+
+    while (j <= right2) {
+        dst[k++] = src[j++]; // Movement
+        counter.movement();
+    }
+}
+
+// Merges the sorted runs src[left..mid] and src[mid + 1..right] into dst[left..right]
+template <typename CountPolicy>
+void mergeInto(const int src[], int dst[], int left, int mid, int right, CountPolicy counter) {
+    mergeRunsInto(src, left, mid, mid + 1, right, dst, left, counter);
+}
+
+// Sorts src[left..right] into dst[left..right], using src as scratch space
+// Both ranges must hold the same elements on entry, so the roles can swap at each level without copying
+template <typename CountPolicy>
+void bufferedMergeSortInto(int src[], int dst[], int left, int right, CountPolicy counter) {
     if (left < right) {
         int mid = left + (right - left) / 2;
-        mergeSort(arr, left, mid, sortResult);
-        mergeSort(arr, mid + 1, right, sortResult);
-        merge(arr, left, mid, right, sortResult);
+        bufferedMergeSortInto(dst, src, left, mid, counter);
+        bufferedMergeSortInto(dst, src, mid + 1, right, counter);
+        mergeInto(src, dst, left, mid, right, counter);
+    }
+}
+
+template <typename CountPolicy>
+void bufferedMergeSort(int arr[], int n, int scratch[], CountPolicy counter) {
+    if (n < 2) {
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        scratch[i] = arr[i]; // Movement
+        counter.movement();
+    }
+
+    bufferedMergeSortInto(scratch, arr, 0, n - 1, counter);
+}
+
+template <typename CountPolicy>
+void bufferedMergeSort(int arr[], int n, CountPolicy counter) {
+    int* scratch = new int[n > 0 ? n : 1]; // One allocation for the whole sort
+    bufferedMergeSort(arr, n, scratch, counter);
+    delete[] scratch;
+}
+
+// Runs shorter than the minimum run length are extended with binary insertion by timSort,
+// and arrays shorter than TIM_SORT_MIN_MERGE are sorted by binary insertion alone
+constexpr int TIM_SORT_MIN_MERGE = 32;
+
+// Consecutive wins by one run after which timSort's merges switch to galloping
+constexpr int TIM_SORT_MIN_GALLOP = 7;
+
+// Pending runs grow at least as fast as the Fibonacci numbers, so 85 covers any int length
+constexpr int TIM_SORT_MAX_PENDING_RUNS = 85;
+
+// Shared state for one timSort call: the array, the merge buffer, and the stack of pending runs
+template <typename CountPolicy>
+struct timSortState {
+    timSortState(int* arr, int* tmp, CountPolicy counter) : arr(arr), tmp(tmp), counter(counter) {}
+
+    int* arr;
+    int* tmp;
+    CountPolicy counter;
+    int minGallop = TIM_SORT_MIN_GALLOP;
+    int stackSize = 0;
+    int runBase[TIM_SORT_MAX_PENDING_RUNS];
+    int runLength[TIM_SORT_MAX_PENDING_RUNS];
+};
+
+// Picks a run length in [TIM_SORT_MIN_MERGE / 2, TIM_SORT_MIN_MERGE] so that n / minRun is a power of two or just below one
+inline int timSortMinRun(int n) {
+    int roundUp = 0;
+    while (n >= TIM_SORT_MIN_MERGE) {
+        roundUp |= n & 1;
+        n >>= 1;
+    }
+    return n + roundUp;
+}
+
+// Returns the length of the run starting at arr[low], stopping before arr[high]
+// A strictly descending run is reversed in place, so every run is ascending afterwards
+// (strictness keeps equal elements in order, which keeps the sort stable)
+template <typename CountPolicy>
+int countRunAndMakeAscending(int arr[], int low, int high, CountPolicy counter) {
+    int runHigh = low + 1;
+    if (runHigh == high) {
+        return 1;
+    }
+
+    counter.comparison(); // Compare arr[low + 1] and arr[low]
+    if (arr[runHigh++] < arr[low]) {
+        while (runHigh < high) {
+            counter.comparison(); // Compare arr[runHigh] and arr[runHigh - 1]
+            if (arr[runHigh] >= arr[runHigh - 1]) {
+                break;
+            }
+            runHigh++;
+        }
+        std::reverse(arr + low, arr + runHigh); // Every element but the middle one moves
+        counter.movement((runHigh - low) / 2 * 2);
+    }
+    else {
+        while (runHigh < high) {
+            counter.comparison(); // Compare arr[runHigh] and arr[runHigh - 1]
+            if (arr[runHigh] < arr[runHigh - 1]) {
+                break;
+            }
+            runHigh++;
+        }
+    }
+
+    return runHigh - low;
+}
+
+// Sorts arr[low..high - 1] given that arr[low..start - 1] is already sorted,
+// finding each insertion point with a binary search
+template <typename CountPolicy>
+void binaryInsertionSort(int arr[], int low, int high, int start, CountPolicy counter) {
+    for (; start < high; start++) {
+        int pivot = arr[start];
+
+        // Insert after any equal elements so the sort stays stable
+        int left = low, right = start;
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+            counter.comparison(); // Compare pivot and arr[mid]
+            if (pivot < arr[mid]) {
+                right = mid;
+            }
+            else {
+                left = mid + 1;
+            }
+        }
+
+        std::copy_backward(arr + left, arr + start, arr + start + 1);
+        arr[left] = pivot; // Movement for each shifted element and the pivot
+        counter.movement(start - left + 1);
+    }
+}
+
+// Returns where key belongs in the sorted run[0..length - 1], before any equal elements
+// Gallops outwards from run[hint] in steps of 1, 3, 7, ... and then binary searches the last step
+template <typename CountPolicy>
+int gallopLeft(int key, const int run[], int length, int hint, CountPolicy counter) {
+    int lastOffset = 0, offset = 1;
+
+    counter.comparison(); // Compare key and run[hint]
+    if (key > run[hint]) {
+        // Gallop right until run[hint + lastOffset] < key <= run[hint + offset]
+        int maxOffset = length - hint;
+        while (offset < maxOffset) {
+            counter.comparison(); // Compare key and run[hint + offset]
+            if (key <= run[hint + offset]) {
+                break;
+            }
+            lastOffset = offset;
+            offset = (offset << 1) + 1;
+            if (offset <= 0) {
+                offset = maxOffset; // Overflow
+            }
+        }
+        offset = std::min(offset, maxOffset);
+        lastOffset += hint;
+        offset += hint;
+    }
+    else {
+        // Gallop left until run[hint - offset] < key <= run[hint - lastOffset]
+        int maxOffset = hint + 1;
+        while (offset < maxOffset) {
+            counter.comparison(); // Compare key and run[hint - offset]
+            if (key > run[hint - offset]) {
+                break;
+            }
+            lastOffset = offset;
+            offset = (offset << 1) + 1;
+            if (offset <= 0) {
+                offset = maxOffset; // Overflow
+            }
+        }
+        offset = std::min(offset, maxOffset);
+        int previous = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - previous;
+    }
+
+    // run[lastOffset] < key <= run[offset], so binary search between them
+    lastOffset++;
+    while (lastOffset < offset) {
+        int mid = lastOffset + (offset - lastOffset) / 2;
+        counter.comparison(); // Compare key and run[mid]
+        if (key > run[mid]) {
+            lastOffset = mid + 1;
+        }
+        else {
+            offset = mid;
+        }
+    }
+    return offset;
+}
+
+// Returns where key belongs in the sorted run[0..length - 1], after any equal elements
+template <typename CountPolicy>
+int gallopRight(int key, const int run[], int length, int hint, CountPolicy counter) {
+    int lastOffset = 0, offset = 1;
+
+    counter.comparison(); // Compare key and run[hint]
+    if (key < run[hint]) {
+        // Gallop left until run[hint - offset] <= key < run[hint - lastOffset]
+        int maxOffset = hint + 1;
+        while (offset < maxOffset) {
+            counter.comparison(); // Compare key and run[hint - offset]
+            if (key >= run[hint - offset]) {
+                break;
+            }
+            lastOffset = offset;
+            offset = (offset << 1) + 1;
+            if (offset <= 0) {
+                offset = maxOffset; // Overflow
+            }
+        }
+        offset = std::min(offset, maxOffset);
+        int previous = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - previous;
+    }
+    else {
+        // Gallop right until run[hint + lastOffset] <= key < run[hint + offset]
+        int maxOffset = length - hint;
+        while (offset < maxOffset) {
+            counter.comparison(); // Compare key and run[hint + offset]
+            if (key < run[hint + offset]) {
+                break;
+            }
+            lastOffset = offset;
+            offset = (offset << 1) + 1;
+            if (offset <= 0) {
+                offset = maxOffset; // Overflow
+            }
+        }
+        offset = std::min(offset, maxOffset);
+        lastOffset += hint;
+        offset += hint;
+    }
+
+    // run[lastOffset] <= key < run[offset], so binary search between them
+    lastOffset++;
+    while (lastOffset < offset) {
+        int mid = lastOffset + (offset - lastOffset) / 2;
+        counter.comparison(); // Compare key and run[mid]
+        if (key < run[mid]) {
+            offset = mid;
+        }
+        else {
+            lastOffset = mid + 1;
+        }
+    }
+    return offset;
+}
+
+// Merges the adjacent runs arr[base1..base1 + length1 - 1] and arr[base2..base2 + length2 - 1]
+// where length1 <= length2, copying the first run to tmp and filling the array from the left
+// arr[base2] must be smaller than the first run's first element, and the first run's last
+// element larger than every element of the second run, which mergeAt ensures by trimming
+template <typename CountPolicy>
+void mergeLow(timSortState<CountPolicy>& state, int base1, int length1, int base2, int length2) {
+    int* arr = state.arr;
+    int* tmp = state.tmp;
+    CountPolicy counter = state.counter;
+
+    std::copy(arr + base1, arr + base1 + length1, tmp);
+    counter.movement(length1);
+
+    int cursor1 = 0, cursor2 = base2, dest = base1;
+    arr[dest++] = arr[cursor2++]; // Movement
+    counter.movement();
+
+    if (--length2 == 0) {
+        std::copy(tmp + cursor1, tmp + cursor1 + length1, arr + dest);
+        counter.movement(length1);
+        return;
+    }
+    if (length1 == 1) {
+        std::copy(arr + cursor2, arr + cursor2 + length2, arr + dest);
+        arr[dest + length2] = tmp[cursor1]; // Last element of the first run is the largest
+        counter.movement(length2 + 1);
+        return;
+    }
+
+    int minGallop = state.minGallop;
+    bool done = false;
+    while (!done) {
+        int count1 = 0, count2 = 0; // Consecutive wins by each run
+
+        // One element at a time until one run starts winning consistently
+        while (true) {
+            counter.comparison(); // Compare arr[cursor2] and tmp[cursor1]
+            if (arr[cursor2] < tmp[cursor1]) {
+                arr[dest++] = arr[cursor2++]; // Movement
+                counter.movement();
+                count2++;
+                count1 = 0;
+                if (--length2 == 0) {
+                    done = true;
+                    break;
+                }
+            }
+            else {
+                arr[dest++] = tmp[cursor1++]; // Movement
+                counter.movement();
+                count1++;
+                count2 = 0;
+                if (--length1 == 1) {
+                    done = true;
+                    break;
+                }
+            }
+            if ((count1 | count2) >= minGallop) {
+                break;
+            }
+        }
+
+        // Galloping: copy whole stretches at once while they stay long
+        while (!done) {
+            count1 = gallopRight(arr[cursor2], tmp + cursor1, length1, 0, counter);
+            if (count1 != 0) {
+                std::copy(tmp + cursor1, tmp + cursor1 + count1, arr + dest);
+                counter.movement(count1);
+                dest += count1;
+                cursor1 += count1;
+                length1 -= count1;
+                if (length1 <= 1) {
+                    done = true;
+                    break;
+                }
+            }
+            arr[dest++] = arr[cursor2++]; // Movement
+            counter.movement();
+            if (--length2 == 0) {
+                done = true;
+                break;
+            }
+
+            count2 = gallopLeft(tmp[cursor1], arr + cursor2, length2, 0, counter);
+            if (count2 != 0) {
+                std::copy(arr + cursor2, arr + cursor2 + count2, arr + dest);
+                counter.movement(count2);
+                dest += count2;
+                cursor2 += count2;
+                length2 -= count2;
+                if (length2 == 0) {
+                    done = true;
+                    break;
+                }
+            }
+            arr[dest++] = tmp[cursor1++]; // Movement
+            counter.movement();
+            if (--length1 == 1) {
+                done = true;
+                break;
+            }
+
+            // Galloping pays off, so make it easier to enter next time
+            minGallop--;
+            if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) {
+                break;
+            }
+        }
+        if (done) {
+            break;
+        }
+
+        // Penalize leaving gallop mode
+        minGallop = std::max(minGallop, 0) + 2;
+    }
+    state.minGallop = std::max(minGallop, 1);
+
+    if (length1 == 1) {
+        std::copy(arr + cursor2, arr + cursor2 + length2, arr + dest);
+        arr[dest + length2] = tmp[cursor1]; // Last element of the first run is the largest
+        counter.movement(length2 + 1);
+    }
+    else {
+        std::copy(tmp + cursor1, tmp + cursor1 + length1, arr + dest);
+        counter.movement(length1);
+    }
+}
+
+// Mirror image of mergeLow for length1 >= length2: the second run is copied to tmp
+// and the array is filled from the right
+template <typename CountPolicy>
+void mergeHigh(timSortState<CountPolicy>& state, int base1, int length1, int base2, int length2) {
+    int* arr = state.arr;
+    int* tmp = state.tmp;
+    CountPolicy counter = state.counter;
+
+    std::copy(arr + base2, arr + base2 + length2, tmp);
+    counter.movement(length2);
+
+    int cursor1 = base1 + length1 - 1, cursor2 = length2 - 1, dest = base2 + length2 - 1;
+    arr[dest--] = arr[cursor1--]; // Movement
+    counter.movement();
+
+    if (--length1 == 0) {
+        std::copy(tmp, tmp + length2, arr + dest - (length2 - 1));
+        counter.movement(length2);
+        return;
+    }
+    if (length2 == 1) {
+        dest -= length1;
+        cursor1 -= length1;
+        std::copy_backward(arr + cursor1 + 1, arr + cursor1 + 1 + length1, arr + dest + 1 + length1);
+        arr[dest] = tmp[cursor2]; // First element of the second run is the smallest
+        counter.movement(length1 + 1);
+        return;
+    }
+
+    int minGallop = state.minGallop;
+    bool done = false;
+    while (!done) {
+        int count1 = 0, count2 = 0; // Consecutive wins by each run
+
+        // One element at a time until one run starts winning consistently
+        while (true) {
+            counter.comparison(); // Compare tmp[cursor2] and arr[cursor1]
+            if (tmp[cursor2] < arr[cursor1]) {
+                arr[dest--] = arr[cursor1--]; // Movement
+                counter.movement();
+                count1++;
+                count2 = 0;
+                if (--length1 == 0) {
+                    done = true;
+                    break;
+                }
+            }
+            else {
+                arr[dest--] = tmp[cursor2--]; // Movement
+                counter.movement();
+                count2++;
+                count1 = 0;
+                if (--length2 == 1) {
+                    done = true;
+                    break;
+                }
+            }
+            if ((count1 | count2) >= minGallop) {
+                break;
+            }
+        }
+
+        // Galloping: copy whole stretches at once while they stay long
+        while (!done) {
+            count1 = length1 - gallopRight(tmp[cursor2], arr + base1, length1, length1 - 1, counter);
+            if (count1 != 0) {
+                dest -= count1;
+                cursor1 -= count1;
+                length1 -= count1;
+                std::copy_backward(arr + cursor1 + 1, arr + cursor1 + 1 + count1, arr + dest + 1 + count1);
+                counter.movement(count1);
+                if (length1 == 0) {
+                    done = true;
+                    break;
+                }
+            }
+            arr[dest--] = tmp[cursor2--]; // Movement
+            counter.movement();
+            if (--length2 == 1) {
+                done = true;
+                break;
+            }
+
+            count2 = length2 - gallopLeft(arr[cursor1], tmp, length2, length2 - 1, counter);
+            if (count2 != 0) {
+                dest -= count2;
+                cursor2 -= count2;
+                length2 -= count2;
+                std::copy(tmp + cursor2 + 1, tmp + cursor2 + 1 + count2, arr + dest + 1);
+                counter.movement(count2);
+                if (length2 <= 1) {
+                    done = true;
+                    break;
+                }
+            }
+            arr[dest--] = arr[cursor1--]; // Movement
+            counter.movement();
+            if (--length1 == 0) {
+                done = true;
+                break;
+            }
+
+            // Galloping pays off, so make it easier to enter next time
+            minGallop--;
+            if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) {
+                break;
+            }
+        }
+        if (done) {
+            break;
+        }
+
+        // Penalize leaving gallop mode
+        minGallop = std::max(minGallop, 0) + 2;
+    }
+    state.minGallop = std::max(minGallop, 1);
+
+    if (length2 == 1) {
+        dest -= length1;
+        cursor1 -= length1;
+        std::copy_backward(arr + cursor1 + 1, arr + cursor1 + 1 + length1, arr + dest + 1 + length1);
+        arr[dest] = tmp[cursor2]; // First element of the second run is the smallest
+        counter.movement(length1 + 1);
+    }
+    else {
+        std::copy(tmp, tmp + length2, arr + dest - (length2 - 1));
+        counter.movement(length2);
+    }
+}
+
+// Merges pending runs i and i + 1, first trimming the elements of each run that are already in place
+template <typename CountPolicy>
+void mergeAt(timSortState<CountPolicy>& state, int i) {
+    int base1 = state.runBase[i], length1 = state.runLength[i];
+    int base2 = state.runBase[i + 1], length2 = state.runLength[i + 1];
+
+    state.runLength[i] = length1 + length2;
+    if (i == state.stackSize - 3) {
+        state.runBase[i + 1] = state.runBase[i + 2];
+        state.runLength[i + 1] = state.runLength[i + 2];
+    }
+    state.stackSize--;
+
+    // Elements of the first run below the second run's first element are already in place
+    int skip = gallopRight(state.arr[base2], state.arr + base1, length1, 0, state.counter);
+    base1 += skip;
+    length1 -= skip;
+    if (length1 == 0) {
+        return;
+    }
+
+    // So are elements of the second run above the first run's last element
+    length2 = gallopLeft(state.arr[base1 + length1 - 1], state.arr + base2, length2, length2 - 1, state.counter);
+    if (length2 == 0) {
+        return;
+    }
+
+    if (length1 <= length2) {
+        mergeLow(state, base1, length1, base2, length2);
+    }
+    else {
+        mergeHigh(state, base1, length1, base2, length2);
+    }
+}
+
+// Merges pending runs until, for the top runs A, B, C (C on top), A > B + C and B > C
+// These invariants keep run lengths balanced and the stack logarithmic in n
+template <typename CountPolicy>
+void mergeCollapse(timSortState<CountPolicy>& state) {
+    while (state.stackSize > 1) {
+        int n = state.stackSize - 2;
+        int* length = state.runLength;
+        if ((n > 0 && length[n - 1] <= length[n] + length[n + 1]) || (n > 1 && length[n - 2] <= length[n - 1] + length[n])) {
+            if (length[n - 1] < length[n + 1]) {
+                n--;
+            }
+        }
+        else if (length[n] > length[n + 1]) {
+            break;
+        }
+        mergeAt(state, n);
+    }
+}
+
+// Merges every pending run once the whole array has been scanned
+template <typename CountPolicy>
+void mergeForceCollapse(timSortState<CountPolicy>& state) {
+    while (state.stackSize > 1) {
+        int n = state.stackSize - 2;
+        if (n > 0 && state.runLength[n - 1] < state.runLength[n + 1]) {
+            n--;
+        }
+        mergeAt(state, n);
     }
 }
+
+template <typename CountPolicy>
+void timSort(int arr[], int n, CountPolicy counter) {
+    if (n < 2) {
+        return;
+    }
+
+    // Small arrays are one run extended by binary insertion, with no merging
+    if (n < TIM_SORT_MIN_MERGE) {
+        int runLength = countRunAndMakeAscending(arr, 0, n, counter);
+        binaryInsertionSort(arr, 0, n, runLength, counter);
+        return;
+    }
+
+    // A merge never buffers more than the shorter run, which is at most n / 2 elements
+    timSortState<CountPolicy> state(arr, new int[n / 2], counter);
+    int minRun = timSortMinRun(n);
+
+    int low = 0, remaining = n;
+    while (remaining != 0) {
+        int runLength = countRunAndMakeAscending(arr, low, n, counter);
+
+        // Extend short runs to minRun with binary insertion
+        if (runLength < minRun) {
+            int forced = std::min(remaining, minRun);
+            binaryInsertionSort(arr, low, low + forced, low + runLength, counter);
+            runLength = forced;
+        }
+
+        state.runBase[state.stackSize] = low;
+        state.runLength[state.stackSize] = runLength;
+        state.stackSize++;
+        mergeCollapse(state);
+
+        low += runLength;
+        remaining -= runLength;
+    }
+
+    mergeForceCollapse(state);
+    delete[] state.tmp;
+}
+
+// Ranges at or below this size are handed to insertionSort by introSort
+constexpr int INTRO_SORT_CUTOFF = 16;
+
+// Orders arr[low], arr[mid], and arr[high] so the median of the three lands in the middle slot
+template <typename CountPolicy>
+void medianOfThree(int arr[], int low, int high, CountPolicy counter) {
+    int mid = low + (high - low) / 2;
+
+    counter.comparison(); // arr[mid] < arr[low] is a comparison
+    if (arr[mid] < arr[low]) {
+        swap(arr[mid], arr[low]); // Swap counts as 2 movements
+        counter.movement(2);
+    }
+
+    counter.comparison(); // arr[high] < arr[low] is a comparison
+    if (arr[high] < arr[low]) {
+        swap(arr[high], arr[low]); // Swap counts as 2 movements
+        counter.movement(2);
+    }
+
+    counter.comparison(); // arr[high] < arr[mid] is a comparison
+    if (arr[high] < arr[mid]) {
+        swap(arr[high], arr[mid]); // Swap counts as 2 movements
+        counter.movement(2);
+    }
+}
+
+// Hoare partition around the median left in arr[mid] by medianOfThree
+// arr[low] and arr[high] act as sentinels, so neither scan needs a bounds check
+// Returns the split point: arr[low..split] <= pivot <= arr[split + 1..high]
+template <typename CountPolicy>
+int introPartition(int arr[], int low, int high, CountPolicy counter) {
+    int pivot = arr[low + (high - low) / 2];
+    int i = low, j = high;
+
+    while (true) {
+        do {
+            i++;
+            counter.comparison(); // arr[i] < pivot is a comparison
+        } while (arr[i] < pivot);
+
+        do {
+            j--;
+            counter.comparison(); // pivot < arr[j] is a comparison
+        } while (pivot < arr[j]);
+
+        if (i >= j) {
+            return j;
+        }
+
+        swap(arr[i], arr[j]); // Swap counts as 2 movements
+        counter.movement(2);
+    }
+}
+
+// Base case used by introSort for ranges at or below INTRO_SORT_CUTOFF
+struct insertionSortBaseCase {
+    template <typename CountPolicy>
+    void operator()(int arr[], int n, CountPolicy counter) const {
+        insertionSort(arr, n, counter);
+    }
+};
+
+// Ranges at or below cutoff are handed to smallSort(first, count, counter)
+template <typename CountPolicy, typename SmallSort>
+void introSortLoop(int arr[], int low, int high, int depthLimit, int cutoff, CountPolicy counter, SmallSort smallSort) {
+    while (high - low + 1 > cutoff) {
+        if (depthLimit == 0) {
+            // Partitioning has gone quadratic, finish this range in guaranteed O(n log n)
+            heapSort(arr + low, high - low + 1, counter);
+            return;
+        }
+        depthLimit--;
+
+        medianOfThree(arr, low, high, counter);
+        int split = introPartition(arr, low, high, counter);
+
+        // Recurse into the smaller side and loop on the larger one so stack depth stays O(log n)
+        if (split - low < high - split) {
+            introSortLoop(arr, low, split, depthLimit, cutoff, counter, smallSort);
+            low = split + 1;
+        }
+        else {
+            introSortLoop(arr, split + 1, high, depthLimit, cutoff, counter, smallSort);
+            high = split;
+        }
+    }
+
+    smallSort(arr + low, high - low + 1, counter);
+}
+
+template <typename CountPolicy>
+void introSortLoop(int arr[], int low, int high, int depthLimit, CountPolicy counter) {
+    introSortLoop(arr, low, high, depthLimit, INTRO_SORT_CUTOFF, counter, insertionSortBaseCase{});
+}
+
+template <typename CountPolicy>
+void introSort(int arr[], int n, CountPolicy counter) {
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2; // 2 * floor(log2(n))
+    }
+
+    introSortLoop(arr, 0, n - 1, depthLimit, counter);
+}
+
+// Ranges below this size are handed to insertionSort by blockQuickSort
+constexpr int BLOCK_QUICK_SORT_CUTOFF = 24;
+
+// Ranges above this size take their pivot from a median of three medians (Tukey's ninther)
+constexpr int NINTHER_THRESHOLD = 128;
+
+// Elements classified per block by blockPartition; offsets within a block fit in an unsigned char
+constexpr int BLOCK_PARTITION_SIZE = 64;
+
+// partialInsertionSort gives up once it has moved this many elements
+constexpr int PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+// Orders arr[a], arr[b], and arr[c] so the median of the three lands in arr[b]
+template <typename CountPolicy>
+void sortThree(int arr[], int a, int b, int c, CountPolicy counter) {
+    counter.comparison(); // arr[b] < arr[a] is a comparison
+    if (arr[b] < arr[a]) {
+        swap(arr[a], arr[b]); // Swap counts as 2 movements
+        counter.movement(2);
+    }
+
+    counter.comparison(); // arr[c] < arr[b] is a comparison
+    if (arr[c] < arr[b]) {
+        swap(arr[b], arr[c]); // Swap counts as 2 movements
+        counter.movement(2);
+
+        counter.comparison(); // arr[b] < arr[a] is a comparison
+        if (arr[b] < arr[a]) {
+            swap(arr[a], arr[b]); // Swap counts as 2 movements
+            counter.movement(2);
+        }
+    }
+}
+
+// Insertion sort that gives up after PARTIAL_INSERTION_SORT_LIMIT moved elements
+// Returns whether arr[0..n - 1] ended up sorted, which it does cheaply for nearly sorted ranges
+template <typename CountPolicy>
+bool partialInsertionSort(int arr[], int n, CountPolicy counter) {
+    int moved = 0;
+    for (int i = 1; i < n; i++) {
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+
+        counter.comparison(); // arr[i] < arr[i - 1] is a comparison
+        if (arr[i] < arr[i - 1]) {
+            int key = arr[i];
+            int j = i;
+            do {
+                arr[j] = arr[j - 1]; // Movement
+                counter.movement();
+                j--;
+                if (j > 0) {
+                    counter.comparison(); // key < arr[j - 1] is a comparison
+                }
+            } while (j > 0 && key < arr[j - 1]);
+
+            arr[j] = key; // Movement
+            counter.movement();
+            moved += i - j;
+        }
+    }
+    return true;
+}
+
+// Exchanges the misplaced elements recorded by blockPartition:
+// arr[left + offsetsLeft[k]] (>= pivot) with arr[right - offsetsRight[k]] (< pivot) for k < count.
+// A cyclic rotation needs one write per element instead of the two of a swap,
+// but when both blocks empty together plain swaps leave fewer elements in flight
+template <typename CountPolicy>
+void swapOffsets(int arr[], int left, int right, const unsigned char offsetsLeft[], const unsigned char offsetsRight[], int count, bool useSwaps, CountPolicy counter) {
+    if (useSwaps) {
+        for (int k = 0; k < count; k++) {
+            swap(arr[left + offsetsLeft[k]], arr[right - offsetsRight[k]]);
+        }
+        counter.movement(2 * count);
+    }
+    else if (count > 0) {
+        int l = left + offsetsLeft[0];
+        int r = right - offsetsRight[0];
+        int carried = arr[l];
+        arr[l] = arr[r];
+        for (int k = 1; k < count; k++) {
+            l = left + offsetsLeft[k];
+            arr[r] = arr[l];
+            r = right - offsetsRight[k];
+            arr[l] = arr[r];
+        }
+        arr[r] = carried;
+        counter.movement(2 * count);
+    }
+}
+
+// Block partition (BlockQuicksort) around the pivot in arr[0], which sortThree or the ninther left there.
+// Instead of branching on every comparison, each side classifies a block of BLOCK_PARTITION_SIZE
+// elements into a buffer of offsets, where the outcome only decides whether the offset counter
+// advances. The misplaced elements are then exchanged in bulk, so no branch depends on the data.
+// Elements equal to the pivot go right. Returns the pivot's final index, and sets alreadyPartitioned
+// when the range needed no exchanges at all, which is the hint for nearly sorted input
+template <typename CountPolicy>
+int blockPartition(int arr[], int n, bool& alreadyPartitioned, CountPolicy counter) {
+    int pivot = arr[0];
+    int first = 0, last = n;
+
+    // Skip the prefix already below the pivot; the median of three guarantees an element >= pivot to stop at
+    do {
+        first++;
+        counter.comparison(); // arr[first] < pivot is a comparison
+    } while (arr[first] < pivot);
+
+    // And the suffix already at or above the pivot, bounds-checked only when nothing stopped the left scan early
+    if (first == 1) {
+        while (first < last) {
+            last--;
+            counter.comparison(); // arr[last] < pivot is a comparison
+            if (arr[last] < pivot) {
+                break;
+            }
+        }
+    }
+    else {
+        do {
+            last--;
+            counter.comparison(); // arr[last] < pivot is a comparison
+        } while (!(arr[last] < pivot));
+    }
+
+    alreadyPartitioned = first >= last;
+    if (!alreadyPartitioned) {
+        swap(arr[first], arr[last]); // Swap counts as 2 movements
+        counter.movement(2);
+        first++;
+
+        alignas(64) unsigned char offsetsLeft[BLOCK_PARTITION_SIZE];
+        alignas(64) unsigned char offsetsRight[BLOCK_PARTITION_SIZE];
+        int countLeft = 0, countRight = 0, startLeft = 0, startRight = 0;
+
+        // arr[first..last - 1] is unclassified; fill whichever buffer ran empty and exchange as many as both hold
+        while (last - first > 2 * BLOCK_PARTITION_SIZE) {
+            if (countLeft == 0) {
+                startLeft = 0;
+                for (int i = 0; i < BLOCK_PARTITION_SIZE; i++) {
+                    offsetsLeft[countLeft] = static_cast<unsigned char>(i);
+                    countLeft += !(arr[first + i] < pivot);
+                }
+                counter.comparison(BLOCK_PARTITION_SIZE);
+            }
+            if (countRight == 0) {
+                startRight = 0;
+                for (int i = 1; i <= BLOCK_PARTITION_SIZE; i++) {
+                    offsetsRight[countRight] = static_cast<unsigned char>(i);
+                    countRight += arr[last - i] < pivot;
+                }
+                counter.comparison(BLOCK_PARTITION_SIZE);
+            }
+
+            int count = std::min(countLeft, countRight);
+            swapOffsets(arr, first, last, offsetsLeft + startLeft, offsetsRight + startRight, count, countLeft == countRight, counter);
+            countLeft -= count;
+            countRight -= count;
+            startLeft += count;
+            startRight += count;
+
+            if (countLeft == 0) {
+                first += BLOCK_PARTITION_SIZE;
+            }
+            if (countRight == 0) {
+                last -= BLOCK_PARTITION_SIZE;
+            }
+        }
+
+        // Classify what is left, splitting it between the sides whose buffers are empty
+        int sizeLeft = 0, sizeRight = 0;
+        int unknown = (last - first) - ((countLeft || countRight) ? BLOCK_PARTITION_SIZE : 0);
+        if (countRight) {
+            sizeLeft = unknown;
+            sizeRight = BLOCK_PARTITION_SIZE;
+        }
+        else if (countLeft) {
+            sizeLeft = BLOCK_PARTITION_SIZE;
+            sizeRight = unknown;
+        }
+        else {
+            sizeLeft = unknown / 2;
+            sizeRight = unknown - sizeLeft;
+        }
+
+        if (unknown && !countLeft) {
+            startLeft = 0;
+            for (int i = 0; i < sizeLeft; i++) {
+                offsetsLeft[countLeft] = static_cast<unsigned char>(i);
+                countLeft += !(arr[first + i] < pivot);
+            }
+            counter.comparison(sizeLeft);
+        }
+        if (unknown && !countRight) {
+            startRight = 0;
+            for (int i = 1; i <= sizeRight; i++) {
+                offsetsRight[countRight] = static_cast<unsigned char>(i);
+                countRight += arr[last - i] < pivot;
+            }
+            counter.comparison(sizeRight);
+        }
+
+        int count = std::min(countLeft, countRight);
+        swapOffsets(arr, first, last, offsetsLeft + startLeft, offsetsRight + startRight, count, countLeft == countRight, counter);
+        countLeft -= count;
+        countRight -= count;
+        startLeft += count;
+        startRight += count;
+
+        if (countLeft == 0) {
+            first += sizeLeft;
+        }
+        if (countRight == 0) {
+            last -= sizeRight;
+        }
+
+        // At most one buffer still holds misplaced elements; move them to the boundary one by one
+        if (countLeft) {
+            while (countLeft--) {
+                last--;
+                swap(arr[first + offsetsLeft[startLeft + countLeft]], arr[last]); // Swap counts as 2 movements
+                counter.movement(2);
+            }
+            first = last;
+        }
+        if (countRight) {
+            while (countRight--) {
+                swap(arr[last - offsetsRight[startRight + countRight]], arr[first]); // Swap counts as 2 movements
+                counter.movement(2);
+                first++;
+            }
+            last = first;
+        }
+    }
+
+    // Put the pivot between the two sides
+    int pivotIndex = first - 1;
+    arr[0] = arr[pivotIndex]; // Movement
+    arr[pivotIndex] = pivot; // Movement
+    counter.movement(2);
+    return pivotIndex;
+}
+
+// Partitions around arr[0] with elements equal to the pivot going left
+// Used when the pivot equals the element before the range, which is the pivot of an enclosing partition:
+// nothing in the range is smaller, so every element equal to the pivot is already in its final place
+template <typename CountPolicy>
+int partitionEqualLeft(int arr[], int n, CountPolicy counter) {
+    int pivot = arr[0];
+    int first = 0, last = n;
+
+    do {
+        last--;
+        counter.comparison(); // pivot < arr[last] is a comparison
+    } while (pivot < arr[last]);
+
+    if (last + 1 == n) {
+        while (first < last) {
+            first++;
+            counter.comparison(); // pivot < arr[first] is a comparison
+            if (pivot < arr[first]) {
+                break;
+            }
+        }
+    }
+    else {
+        do {
+            first++;
+            counter.comparison(); // pivot < arr[first] is a comparison
+        } while (!(pivot < arr[first]));
+    }
+
+    while (first < last) {
+        swap(arr[first], arr[last]); // Swap counts as 2 movements
+        counter.movement(2);
+        do {
+            last--;
+            counter.comparison(); // pivot < arr[last] is a comparison
+        } while (pivot < arr[last]);
+        do {
+            first++;
+            counter.comparison(); // pivot < arr[first] is a comparison
+        } while (!(pivot < arr[first]));
+    }
+
+    arr[0] = arr[last]; // Movement
+    arr[last] = pivot; // Movement
+    counter.movement(2);
+    return last;
+}
+
+// Pattern-defeating quicksort loop over arr[0..n - 1]
+// leftmost is false when arr[-1] holds the pivot of an enclosing partition, which bounds the range from below.
+// badAllowed counts the unbalanced partitions left before the range falls back to heapSort
+template <typename CountPolicy>
+void blockQuickSortLoop(int arr[], int n, int badAllowed, bool leftmost, CountPolicy counter) {
+    while (n >= BLOCK_QUICK_SORT_CUTOFF) {
+        // Leave the pivot in arr[0]
+        int half = n / 2;
+        if (n > NINTHER_THRESHOLD) {
+            sortThree(arr, 0, half, n - 1, counter);
+            sortThree(arr, 1, half - 1, n - 2, counter);
+            sortThree(arr, 2, half + 1, n - 3, counter);
+            sortThree(arr, half - 1, half, half + 1, counter);
+            swap(arr[0], arr[half]); // Swap counts as 2 movements
+            counter.movement(2);
+        }
+        else {
+            sortThree(arr, half, 0, n - 1, counter);
+        }
+
+        // A pivot equal to the enclosing pivot means a run of duplicates; put them all left and skip them
+        if (!leftmost) {
+            counter.comparison(); // arr[-1] < arr[0] is a comparison
+            if (!(arr[-1] < arr[0])) {
+                int pivotIndex = partitionEqualLeft(arr, n, counter);
+                arr += pivotIndex + 1;
+                n -= pivotIndex + 1;
+                continue;
+            }
+        }
+
+        bool alreadyPartitioned = false;
+        int pivotIndex = blockPartition(arr, n, alreadyPartitioned, counter);
+        int leftSize = pivotIndex;
+        int rightSize = n - pivotIndex - 1;
+
+        if (leftSize < n / 8 || rightSize < n / 8) {
+            // Too unbalanced: after enough of these, finish in guaranteed O(n log n)
+            if (--badAllowed == 0) {
+                heapSort(arr, n, counter);
+                return;
+            }
+
+            // Otherwise break up whatever pattern produced the bad pivot by swapping a few elements
+            if (leftSize >= BLOCK_QUICK_SORT_CUTOFF) {
+                swap(arr[0], arr[leftSize / 4]);
+                swap(arr[pivotIndex - 1], arr[pivotIndex - leftSize / 4]);
+                counter.movement(4);
+                if (leftSize > NINTHER_THRESHOLD) {
+                    swap(arr[1], arr[leftSize / 4 + 1]);
+                    swap(arr[2], arr[leftSize / 4 + 2]);
+                    swap(arr[pivotIndex - 2], arr[pivotIndex - (leftSize / 4 + 1)]);
+                    swap(arr[pivotIndex - 3], arr[pivotIndex - (leftSize / 4 + 2)]);
+                    counter.movement(8);
+                }
+            }
+            if (rightSize >= BLOCK_QUICK_SORT_CUTOFF) {
+                swap(arr[pivotIndex + 1], arr[pivotIndex + 1 + rightSize / 4]);
+                swap(arr[n - 1], arr[n - rightSize / 4]);
+                counter.movement(4);
+                if (rightSize > NINTHER_THRESHOLD) {
+                    swap(arr[pivotIndex + 2], arr[pivotIndex + 2 + rightSize / 4]);
+                    swap(arr[pivotIndex + 3], arr[pivotIndex + 3 + rightSize / 4]);
+                    swap(arr[n - 2], arr[n - (1 + rightSize / 4)]);
+                    swap(arr[n - 3], arr[n - (2 + rightSize / 4)]);
+                    counter.movement(8);
+                }
+            }
+        }
+        else if (alreadyPartitioned) {
+            // No exchanges were needed, so the input may well be sorted already; check cheaply
+            if (partialInsertionSort(arr, pivotIndex, counter) && partialInsertionSort(arr + pivotIndex + 1, rightSize, counter)) {
+                return;
+            }
+        }
+
+        // Recurse into the left side and loop on the right, whose left neighbour is now the pivot
+        blockQuickSortLoop(arr, leftSize, badAllowed, leftmost, counter);
+        arr += pivotIndex + 1;
+        n = rightSize;
+        leftmost = false;
+    }
+
+    insertionSort(arr, n, counter);
+}
+
+template <typename CountPolicy>
+void blockQuickSort(int arr[], int n, CountPolicy counter) {
+    int badAllowed = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        badAllowed++; // floor(log2(n))
+    }
+
+    blockQuickSortLoop(arr, n, badAllowed, true, counter);
+}
+
+// Sorts a block of at most NETWORK_BLOCK_SIZE elements with the sorting network kernel
+// Comparisons are the network's comparators, movements are the elements written back
+template <typename CountPolicy>
+void networkSortBlock(int arr[], int n, CountPolicy counter) {
+    if (n < 2) {
+        return;
+    }
+
+    networkSortBlock(arr, n);
+    counter.comparison(networkSortComparators(n));
+    counter.movement(n);
+}
+
+// Base case used by networkIntroSort for ranges at or below NETWORK_BLOCK_SIZE
+struct networkSortBaseCase {
+    template <typename CountPolicy>
+    void operator()(int arr[], int n, CountPolicy counter) const {
+        networkSortBlock(arr, n, counter);
+    }
+};
+
+template <typename CountPolicy>
+void networkIntroSort(int arr[], int n, CountPolicy counter) {
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2; // 2 * floor(log2(n))
+    }
+
+    introSortLoop(arr, 0, n - 1, depthLimit, NETWORK_BLOCK_SIZE, counter, networkSortBaseCase{});
+}
+
+// Bottom-up merge sort: network-sorted blocks are merged pairwise with the vector merge,
+// ping-ponging between the array and the scratch buffer
+template <typename CountPolicy>
+void networkMergeSort(int arr[], int n, int scratch[], CountPolicy counter) {
+    for (int i = 0; i < n; i += NETWORK_BLOCK_SIZE) {
+        networkSortBlock(arr + i, min(NETWORK_BLOCK_SIZE, n - i), counter);
+    }
+
+    int* src = arr;
+    int* dst = scratch;
+    for (int width = NETWORK_BLOCK_SIZE; width < n; width *= 2) {
+        for (int left = 0; left < n; left += 2 * width) {
+            int mid = min(left + width, n);
+            int right = min(left + 2 * width, n);
+            counter.comparison(networkMergeRuns(src + left, mid - left, src + mid, right - mid, dst + left));
+            counter.movement(right - left); // Every merged element is written once
+        }
+        swap(src, dst);
+    }
+
+    // An odd number of merge passes leaves the result in the scratch buffer
+    if (src != arr) {
+        for (int i = 0; i < n; i++) {
+            arr[i] = src[i]; // Movement
+            counter.movement();
+        }
+    }
+}
+
+template <typename CountPolicy>
+void networkMergeSort(int arr[], int n, CountPolicy counter) {
+    int* scratch = new int[n > 0 ? n : 1]; // One allocation for the whole sort
+    networkMergeSort(arr, n, scratch, counter);
+    delete[] scratch;
+}
+
+// Number of bits sorted per radixSort pass
+constexpr int RADIX_BITS = 8;
+constexpr int RADIX_BUCKETS = 1 << RADIX_BITS;
+constexpr int RADIX_PASSES = 32 / RADIX_BITS;
+
+// Flipping the sign bit maps signed ints onto unsigned keys in the same order
+inline unsigned radixKey(int value) {
+    return static_cast<unsigned>(value) ^ 0x80000000u;
+}
+
+template <typename CountPolicy>
+void radixSort(int arr[], int n, int scratch[], CountPolicy counter) {
+    if (n < 2) {
+        return;
+    }
+
+    // Build every pass's histogram in a single read of the input
+    unsigned counts[RADIX_PASSES][RADIX_BUCKETS] = {};
+    for (int i = 0; i < n; i++) {
+        unsigned key = radixKey(arr[i]);
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    int* src = arr;
+    int* dst = scratch;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        int shift = pass * RADIX_BITS;
+
+        // Every key shares this digit, so the pass would not change the order
+        if (counts[pass][(radixKey(src[0]) >> shift) & (RADIX_BUCKETS - 1)] == static_cast<unsigned>(n)) {
+            continue;
+        }
+
+        // Turn the histogram into starting offsets for each bucket
+        unsigned offsets[RADIX_BUCKETS];
+        unsigned total = 0;
+        for (int bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+            offsets[bucket] = total;
+            total += counts[pass][bucket];
+        }
+
+        for (int i = 0; i < n; i++) {
+            dst[offsets[(radixKey(src[i]) >> shift) & (RADIX_BUCKETS - 1)]++] = src[i]; // Movement
+            counter.movement();
+        }
+
+        swap(src, dst);
+    }
+
+    // An odd number of passes leaves the result in the scratch buffer
+    if (src != arr) {
+        for (int i = 0; i < n; i++) {
+            arr[i] = src[i]; // Movement
+            counter.movement();
+        }
+    }
+}
+
+template <typename CountPolicy>
+void radixSort(int arr[], int n, CountPolicy counter) {
+    int* scratch = new int[n > 0 ? n : 1]; // One allocation for the whole sort
+    radixSort(arr, n, scratch, counter);
+    delete[] scratch;
+}
+
+// Fork-join thread pool where each worker owns a deque of tasks
+// Workers pop their own newest task and steal the oldest task from other workers when idle
+class workStealingPool {
+public:
+    using taskGroup = std::atomic<int>;
+
+    // threadCount includes the calling thread, which joins in while it waits
+    explicit workStealingPool(int threadCount) : stopping(false), queuedTasks(0) {
+        for (int i = 0; i < threadCount; i++) {
+            queues.push_back(std::make_unique<workerQueue>());
+        }
+        for (int i = 1; i < threadCount; i++) {
+            threads.emplace_back(&workStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ~workStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    int threadCount() const {
+        return static_cast<int>(queues.size());
+    }
+
+    // Index of the calling thread within this pool, the thread that created the pool is 0
+    int workerIndex() const {
+        return currentPool == this ? currentWorker : 0;
+    }
+
+    // Queues work on the calling thread's deque, group counts the tasks still outstanding
+    void spawn(taskGroup& group, std::function<void()> work) {
+        group++;
+        workerQueue& queue = *queues[workerIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.lock);
+            queue.tasks.push_back(task{ std::move(work), &group });
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepLock);
+            queuedTasks++;
+        }
+        wake.notify_one();
+    }
+
+    // Runs queued tasks until every task in group has finished
+    void wait(taskGroup& group) {
+        int self = workerIndex();
+        while (group > 0) {
+            if (!tryRunTask(self)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct task {
+        std::function<void()> work;
+        taskGroup* group;
+    };
+
+    struct workerQueue {
+        std::mutex lock;
+        std::deque<task> tasks;
+    };
+
+    bool tryRunTask(int self) {
+        task next;
+        bool found = false;
+
+        {
+            workerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.lock);
+            if (!own.tasks.empty()) {
+                next = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                found = true;
+            }
+        }
+
+        for (int offset = 1; !found && offset < threadCount(); offset++) {
+            workerQueue& victim = *queues[(self + offset) % threadCount()];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (!victim.tasks.empty()) {
+                next = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+
+        queuedTasks--;
+        next.work();
+        (*next.group)--;
+        return true;
+    }
+
+    void workerLoop(int index) {
+        currentPool = this;
+        currentWorker = index;
+
+        while (true) {
+            if (tryRunTask(index)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepLock);
+            wake.wait(lock, [this] { return stopping || queuedTasks > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<workerQueue>> queues;
+    std::vector<std::thread> threads;
+    bool stopping;
+    std::atomic<int> queuedTasks;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+
+    static thread_local const workStealingPool* currentPool;
+    static thread_local int currentWorker;
+};
+
+thread_local const workStealingPool* workStealingPool::currentPool = nullptr;
+thread_local int workStealingPool::currentWorker = 0;
+
+// Ranges at or below this size are sorted by a single thread in the parallel sorts
+constexpr int PARALLEL_SORT_CUTOFF = 8192;
+
+// Each worker counts into its own cache line so the hot loops never share or lock counters
+struct alignas(64) workerResults {
+    sortResults sortResult;
+};
+
+// Picks the counting policy a worker uses for its own slot
+countingPolicy workerCounter(countingPolicy, sortResults& slot) {
+    return countingPolicy{ slot };
+}
+
+noCountingPolicy workerCounter(noCountingPolicy, sortResults&) {
+    return noCountingPolicy{};
+}
+
+// Shared state for one parallel sort call
+struct parallelSortContext {
+    workStealingPool& pool;
+    std::vector<workerResults>& slots;
+    int sequentialCutoff;
+
+    sortResults& slot() {
+        return slots[pool.workerIndex()].sortResult;
+    }
+};
+
+// Guards sharedSortPool, held for a whole parallel sort so concurrent calls take turns with the pool
+std::mutex sharedSortPoolLock;
+
+// The pool the parallel sorts run on, started by the first call and kept for later ones so short sorts
+// do not pay for starting and joining threads. Restarted only when a call asks for a different thread count
+workStealingPool& sharedSortPool(int threadCount) {
+    static std::unique_ptr<workStealingPool> pool;
+    if (!pool || pool->threadCount() != threadCount) {
+        pool.reset(); // Join the old threads first
+        pool = std::make_unique<workStealingPool>(threadCount);
+    }
+    return *pool;
+}
+
+// Ranges the parallel sorts hand to their sequential kernel, at least 2
+int resolveSequentialCutoff(int sequentialCutoff) {
+    return std::max(2, sequentialCutoff);
+}
+
+// Resolves the thread count and sequential cutoff, runs sortBody on the shared pool, then folds the per-worker counts into counter
+template <typename CountPolicy, typename SortBody>
+void runParallelSort(int threadCount, int sequentialCutoff, CountPolicy counter, SortBody sortBody) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    std::vector<workerResults> slots(threadCount, workerResults{ sortResults{} });
+    {
+        std::lock_guard<std::mutex> lock(sharedSortPoolLock);
+        parallelSortContext context{ sharedSortPool(threadCount), slots, resolveSequentialCutoff(sequentialCutoff) };
+        sortBody(context);
+    }
+
+    for (const workerResults& slot : slots) {
+        counter.comparison(slot.sortResult.comparisons);
+        counter.movement(slot.sortResult.movements);
+    }
+}
+
+// Merges src[left1..right1] and src[left2..right2] into dst starting at dst[k]
+// Large merges are split around the median of the longer run, found in the other run by binary search
+template <typename CountPolicy>
+void parallelMergeRunsInto(parallelSortContext& context, const int src[], int left1, int right1, int left2, int right2, int dst[], int k, CountPolicy counter) {
+    int n1 = right1 - left1 + 1;
+    int n2 = right2 - left2 + 1;
+
+    if (n1 + n2 <= context.sequentialCutoff) {
+        mergeRunsInto(src, left1, right1, left2, right2, dst, k, workerCounter(counter, context.slot()));
+        return;
+    }
+
+    CountPolicy local = workerCounter(counter, context.slot());
+    int mid1, mid2;
+    int lowRight1, lowRight2, highLeft1, highLeft2;
+
+    if (n1 >= n2) {
+        // Elements of run 2 equal to the split value go after it to keep the merge stable
+        mid1 = left1 + (n1 - 1) / 2;
+        int low = left2, high = right2 + 1;
+        while (low < high) {
+            int probe = low + (high - low) / 2;
+            local.comparison(); // src[probe] < src[mid1] is a comparison
+            if (src[probe] < src[mid1]) {
+                low = probe + 1;
+            }
+            else {
+                high = probe;
+            }
+        }
+        mid2 = low;
+        lowRight1 = mid1 - 1;
+        lowRight2 = mid2 - 1;
+        highLeft1 = mid1 + 1;
+        highLeft2 = mid2;
+        dst[k + (mid1 - left1) + (mid2 - left2)] = src[mid1]; // Movement
+    }
+    else {
+        // Elements of run 1 equal to the split value go before it to keep the merge stable
+        mid2 = left2 + (n2 - 1) / 2;
+        int low = left1, high = right1 + 1;
+        while (low < high) {
+            int probe = low + (high - low) / 2;
+            local.comparison(); // src[mid2] < src[probe] is a comparison
+            if (src[mid2] < src[probe]) {
+                high = probe;
+            }
+            else {
+                low = probe + 1;
+            }
+        }
+        mid1 = low;
+        lowRight1 = mid1 - 1;
+        lowRight2 = mid2 - 1;
+        highLeft1 = mid1;
+        highLeft2 = mid2 + 1;
+        dst[k + (mid1 - left1) + (mid2 - left2)] = src[mid2]; // Movement
+    }
+    local.movement();
+
+    int highK = k + (mid1 - left1) + (mid2 - left2) + 1;
+    workStealingPool::taskGroup group(0);
+    context.pool.spawn(group, [&] {
+        parallelMergeRunsInto(context, src, left1, lowRight1, left2, lowRight2, dst, k, counter);
+    });
+    parallelMergeRunsInto(context, src, highLeft1, right1, highLeft2, right2, dst, highK, counter);
+    context.pool.wait(group);
+}
+
+// Parallel counterpart of bufferedMergeSortInto, the two halves run as separate tasks
+template <typename CountPolicy>
+void parallelMergeSortInto(parallelSortContext& context, int src[], int dst[], int left, int right, CountPolicy counter) {
+    if (right - left + 1 <= context.sequentialCutoff) {
+        bufferedMergeSortInto(src, dst, left, right, workerCounter(counter, context.slot()));
+        return;
+    }
+
+    int mid = left + (right - left) / 2;
+    workStealingPool::taskGroup group(0);
+    context.pool.spawn(group, [&] {
+        parallelMergeSortInto(context, dst, src, left, mid, counter);
+    });
+    parallelMergeSortInto(context, dst, src, mid + 1, right, counter);
+    context.pool.wait(group);
+
+    parallelMergeRunsInto(context, src, left, mid, mid + 1, right, dst, left, counter);
+}
+
+template <typename CountPolicy>
+void parallelMergeSort(int arr[], int n, int threadCount, int sequentialCutoff, CountPolicy counter) {
+    if (n < 2) {
+        return;
+    }
+
+    int* scratch = new int[n]; // One allocation for the whole sort
+
+    // Input the sequential kernel would take whole never touches the pool
+    if (n <= resolveSequentialCutoff(sequentialCutoff)) {
+        for (int i = 0; i < n; i++) {
+            scratch[i] = arr[i]; // Movement
+            counter.movement();
+        }
+        bufferedMergeSortInto(scratch, arr, 0, n - 1, counter);
+        delete[] scratch;
+        return;
+    }
+
+    runParallelSort(threadCount, sequentialCutoff, counter, [&](parallelSortContext& context) {
+        CountPolicy local = workerCounter(counter, context.slot());
+        for (int i = 0; i < n; i++) {
+            scratch[i] = arr[i]; // Movement
+            local.movement();
+        }
+        parallelMergeSortInto(context, scratch, arr, 0, n - 1, counter);
+    });
+    delete[] scratch;
+}
+
+template <typename CountPolicy>
+void parallelMergeSort(int arr[], int n, CountPolicy counter) {
+    parallelMergeSort(arr, n, 0, PARALLEL_SORT_CUTOFF, counter);
+}
+
+// Parallel counterpart of introSortLoop, the smaller side of each partition runs as a separate task
+template <typename CountPolicy>
+void parallelQuickSortLoop(parallelSortContext& context, int arr[], int low, int high, int depthLimit, CountPolicy counter) {
+    workStealingPool::taskGroup group(0);
+
+    while (high - low + 1 > context.sequentialCutoff) {
+        CountPolicy local = workerCounter(counter, context.slot());
+        if (depthLimit == 0) {
+            heapSort(arr + low, high - low + 1, local);
+            context.pool.wait(group);
+            return;
+        }
+        depthLimit--;
+
+        medianOfThree(arr, low, high, local);
+        int split = introPartition(arr, low, high, local);
+
+        if (split - low < high - split) {
+            context.pool.spawn(group, [&context, arr, low, split, depthLimit, counter] {
+                parallelQuickSortLoop(context, arr, low, split, depthLimit, counter);
+            });
+            low = split + 1;
+        }
+        else {
+            context.pool.spawn(group, [&context, arr, split, high, depthLimit, counter] {
+                parallelQuickSortLoop(context, arr, split + 1, high, depthLimit, counter);
+            });
+            high = split;
+        }
+    }
+
+    introSortLoop(arr, low, high, depthLimit, workerCounter(counter, context.slot()));
+    context.pool.wait(group);
+}
+
+template <typename CountPolicy>
+void parallelQuickSort(int arr[], int n, int threadCount, int sequentialCutoff, CountPolicy counter) {
+    if (n < 2) {
+        return;
+    }
+
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2; // 2 * floor(log2(n))
+    }
+
+    // Input the sequential kernel would take whole never touches the pool
+    if (n <= resolveSequentialCutoff(sequentialCutoff)) {
+        introSortLoop(arr, 0, n - 1, depthLimit, counter);
+        return;
+    }
+
+    runParallelSort(threadCount, sequentialCutoff, counter, [&](parallelSortContext& context) {
+        parallelQuickSortLoop(context, arr, 0, n - 1, depthLimit, counter);
+    });
+}
+
+template <typename CountPolicy>
+void parallelQuickSort(int arr[], int n, CountPolicy counter) {
+    parallelQuickSort(arr, n, 0, PARALLEL_SORT_CUTOFF, counter);
+}
+
+// Instrumented entry points record every comparison and movement into sortResult
+void insertionSort(int arr[], int n, sortResults& sortResult) {
+    insertionSort(arr, n, countingPolicy{ sortResult });
+}
+
+void quickSort(int arr[], int low, int high, sortResults& sortResult) {
+    quickSort(arr, low, high, countingPolicy{ sortResult });
+}
+
+void quickSort(int arr[], int low, int high, bool threeWay, sortResults& sortResult) {
+    quickSort(arr, low, high, threeWay, countingPolicy{ sortResult });
+}
+
+void mergeSort(int arr[], int left, int right, sortResults& sortResult) {
+    mergeSort(arr, left, right, countingPolicy{ sortResult });
+}
+
+void heapSort(int arr[], int n, sortResults& sortResult) {
+    heapSort(arr, n, countingPolicy{ sortResult });
+}
+
+void nthElement(int arr[], int n, int k, sortResults& sortResult) {
+    nthElement(arr, n, k, countingPolicy{ sortResult });
+}
+
+void partialSort(int arr[], int n, int k, sortResults& sortResult) {
+    partialSort(arr, n, k, countingPolicy{ sortResult });
+}
+
+void timSort(int arr[], int n, sortResults& sortResult) {
+    timSort(arr, n, countingPolicy{ sortResult });
+}
+
+void bottomUpHeapSort(int arr[], int n, sortResults& sortResult) {
+    bottomUpHeapSort(arr, n, countingPolicy{ sortResult });
+}
+
+void bottomUpHeapSort(int arr[], int n, int arity, bool alignSiblings, sortResults& sortResult) {
+    bottomUpHeapSort(arr, n, arity, alignSiblings, countingPolicy{ sortResult });
+}
+
+void introSort(int arr[], int n, sortResults& sortResult) {
+    introSort(arr, n, countingPolicy{ sortResult });
+}
+
+void blockQuickSort(int arr[], int n, sortResults& sortResult) {
+    blockQuickSort(arr, n, countingPolicy{ sortResult });
+}
+
+void bufferedMergeSort(int arr[], int n, sortResults& sortResult) {
+    bufferedMergeSort(arr, n, countingPolicy{ sortResult });
+}
+
+void bufferedMergeSort(int arr[], int n, int scratch[], sortResults& sortResult) {
+    bufferedMergeSort(arr, n, scratch, countingPolicy{ sortResult });
+}
+
+void networkIntroSort(int arr[], int n, sortResults& sortResult) {
+    networkIntroSort(arr, n, countingPolicy{ sortResult });
+}
+
+void networkMergeSort(int arr[], int n, sortResults& sortResult) {
+    networkMergeSort(arr, n, countingPolicy{ sortResult });
+}
+
+void radixSort(int arr[], int n, sortResults& sortResult) {
+    radixSort(arr, n, countingPolicy{ sortResult });
+}
+
+void radixSort(int arr[], int n, int scratch[], sortResults& sortResult) {
+    radixSort(arr, n, scratch, countingPolicy{ sortResult });
+}
+
+void parallelMergeSort(int arr[], int n, sortResults& sortResult) {
+    parallelMergeSort(arr, n, countingPolicy{ sortResult });
+}
+
+void parallelMergeSort(int arr[], int n, int threadCount, int sequentialCutoff, sortResults& sortResult) {
+    parallelMergeSort(arr, n, threadCount, sequentialCutoff, countingPolicy{ sortResult });
+}
+
+void parallelQuickSort(int arr[], int n, sortResults& sortResult) {
+    parallelQuickSort(arr, n, countingPolicy{ sortResult });
+}
+
+void parallelQuickSort(int arr[], int n, int threadCount, int sequentialCutoff, sortResults& sortResult) {
+    parallelQuickSort(arr, n, threadCount, sequentialCutoff, countingPolicy{ sortResult });
+}
+
+// Explicit instantiations for both counting policies
+template void insertionSort<countingPolicy>(int[], int, countingPolicy);
+template void insertionSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void quickSort<countingPolicy>(int[], int, int, countingPolicy);
+template void quickSort<noCountingPolicy>(int[], int, int, noCountingPolicy);
+template void quickSort<countingPolicy>(int[], int, int, bool, countingPolicy);
+template void quickSort<noCountingPolicy>(int[], int, int, bool, noCountingPolicy);
+template void mergeSort<countingPolicy>(int[], int, int, countingPolicy);
+template void mergeSort<noCountingPolicy>(int[], int, int, noCountingPolicy);
+template void heapSort<countingPolicy>(int[], int, countingPolicy);
+template void heapSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void nthElement<countingPolicy>(int[], int, int, countingPolicy);
+template void nthElement<noCountingPolicy>(int[], int, int, noCountingPolicy);
+template void partialSort<countingPolicy>(int[], int, int, countingPolicy);
+template void partialSort<noCountingPolicy>(int[], int, int, noCountingPolicy);
+template void streamingTopK::push<countingPolicy>(int, countingPolicy);
+template void streamingTopK::push<noCountingPolicy>(int, noCountingPolicy);
+template std::vector<int> streamingTopK::sorted<countingPolicy>(countingPolicy) const;
+template std::vector<int> streamingTopK::sorted<noCountingPolicy>(noCountingPolicy) const;
+template void bottomUpHeapSort<countingPolicy>(int[], int, countingPolicy);
+template void bottomUpHeapSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void bottomUpHeapSort<countingPolicy>(int[], int, int, bool, countingPolicy);
+template void bottomUpHeapSort<noCountingPolicy>(int[], int, int, bool, noCountingPolicy);
+template void bufferedMergeSort<countingPolicy>(int[], int, countingPolicy);
+template void bufferedMergeSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void bufferedMergeSort<countingPolicy>(int[], int, int[], countingPolicy);
+template void bufferedMergeSort<noCountingPolicy>(int[], int, int[], noCountingPolicy);
+template void timSort<countingPolicy>(int[], int, countingPolicy);
+template void timSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void introSort<countingPolicy>(int[], int, countingPolicy);
+template void introSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void blockQuickSort<countingPolicy>(int[], int, countingPolicy);
+template void blockQuickSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void parallelMergeSort<countingPolicy>(int[], int, countingPolicy);
+template void parallelMergeSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void parallelMergeSort<countingPolicy>(int[], int, int, int, countingPolicy);
+template void parallelMergeSort<noCountingPolicy>(int[], int, int, int, noCountingPolicy);
+template void parallelQuickSort<countingPolicy>(int[], int, countingPolicy);
+template void parallelQuickSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void parallelQuickSort<countingPolicy>(int[], int, int, int, countingPolicy);
+template void parallelQuickSort<noCountingPolicy>(int[], int, int, int, noCountingPolicy);
+template void radixSort<countingPolicy>(int[], int, countingPolicy);
+template void radixSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void radixSort<countingPolicy>(int[], int, int[], countingPolicy);
+template void radixSort<noCountingPolicy>(int[], int, int[], noCountingPolicy);
+template void networkIntroSort<countingPolicy>(int[], int, countingPolicy);
+template void networkIntroSort<noCountingPolicy>(int[], int, noCountingPolicy);
+template void networkMergeSort<countingPolicy>(int[], int, countingPolicy);
+template void networkMergeSort<noCountingPolicy>(int[], int, noCountingPolicy);
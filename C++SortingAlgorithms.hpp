@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 /**
  * @struct sortResults
  * @brief Holds the performance metrics of sorting algorithms.
@@ -7,10 +9,46 @@
  * @var comparisons  Number of element comparisons made during sorting.
  * @var movements    Number of element movements during sorting.
  * @var duration     Time taken to perform the sort (in unspecified units).
+ * @var uninstrumentedDuration Time taken by the same sort with counting compiled out (mean when repeated).
+ * @var iterations   Number of timed uninstrumented runs behind the statistics below.
+ * @var minDuration  Fastest uninstrumented run.
+ * @var medianDuration Median uninstrumented run.
+ * @var p95Duration  95th percentile uninstrumented run.
+ * @var stddevDuration Sample standard deviation of the uninstrumented runs.
+ * @var cycles, instructions, l1dMisses, llcMisses, branchMisses
+ *                   Hardware counter means over the uninstrumented runs, 0 when not collected.
  */
 struct sortResults {
     unsigned long long comparisons, movements;
     unsigned long long duration;
+    unsigned long long uninstrumentedDuration;
+    unsigned long long iterations;
+    unsigned long long minDuration, medianDuration, p95Duration;
+    double stddevDuration;
+    unsigned long long cycles, instructions;
+    unsigned long long l1dMisses, llcMisses, branchMisses;
+};
+
+/**
+ * @struct countingPolicy
+ * @brief Counting policy that records comparisons and movements into a sortResults.
+ *
+ * @var sortResult   Struct that receives the counts.
+ */
+struct countingPolicy {
+    sortResults& sortResult;
+
+    void comparison(unsigned long long count = 1) { sortResult.comparisons += count; }
+    void movement(unsigned long long count = 1) { sortResult.movements += count; }
+};
+
+/**
+ * @struct noCountingPolicy
+ * @brief Counting policy whose calls are empty, so the sorts compile down to uninstrumented code.
+ */
+struct noCountingPolicy {
+    void comparison(unsigned long long = 1) {}
+    void movement(unsigned long long = 1) {}
 };
 
 /**
@@ -32,6 +70,21 @@ void insertionSort(int arr[], int n, sortResults& sortResult);
  */
 void quickSort(int arr[], int low, int high, sortResults& sortResult);
 
+/**
+ * @brief Sorts an array using Quick Sort with a choice of two-way or three-way partitioning.
+ *
+ * The three-way mode uses a Bentley-McIlroy partition that gathers every key equal to the
+ * pivot in the middle and leaves it out of recursion, so inputs with few distinct keys take
+ * O(n log k) comparisons for k distinct keys instead of degrading toward quadratic.
+ *
+ * @param arr        The array to be sorted.
+ * @param low        The starting index of the array segment to sort.
+ * @param high       The ending index of the array segment to sort.
+ * @param threeWay   Whether to partition three ways (<, ==, >) instead of two.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void quickSort(int arr[], int low, int high, bool threeWay, sortResults& sortResult);
+
 /**
  * @brief Sorts an array using the Merge Sort algorithm.
  *
@@ -49,4 +102,501 @@ void mergeSort(int arr[], int left, int right, sortResults& sortResult);
  * @param n          The number of elements in the array.
  * @param sortResult Struct to store the sorting performance metrics.
  */
-void heapSort(int arr[], int n, sortResults& sortResult);
\ No newline at end of file
+void heapSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Moves the k-th smallest element to arr[k], with no larger element before it and no smaller one after.
+ *
+ * Introselect: Quick Sort's partition() applied only to the side holding k, O(n) on average.
+ * Once the partitions have missed k 2 * log2(n) times, it selects with a bounded heap
+ * instead, O(n log k). Taking k = n / 2 finds a median.
+ *
+ * @param arr        The array to partially order.
+ * @param n          The number of elements in the array.
+ * @param k          The zero-based rank to select; out of range does nothing.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void nthElement(int arr[], int n, int k, sortResults& sortResult);
+
+/**
+ * @brief Sorts the k smallest elements of an array into arr[0..k - 1], leaving the rest in unspecified order.
+ *
+ * Builds a max-heap of the first k elements with heapify(), swaps in every later element
+ * smaller than its root, then sorts the heap. Elements that cannot be among the k smallest
+ * cost one comparison each, so the work is O(n + k log k log(n / k)) on random input and
+ * O(n log k) at worst, against O(n log n) for a full sort.
+ *
+ * @param arr        The array to partially sort.
+ * @param n          The number of elements in the array.
+ * @param k          Number of smallest elements to sort, clamped to [0, n].
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void partialSort(int arr[], int n, int k, sortResults& sortResult);
+
+/**
+ * @class streamingTopK
+ * @brief Keeps the k smallest values of a stream of any length in O(k) memory.
+ *
+ * The values are held in a bounded max-heap. Once k values are kept, each new value costs
+ * one comparison against the largest, and O(log k) work only when it displaces it.
+ */
+class streamingTopK {
+public:
+    /**
+     * @param k Number of smallest values to keep.
+     */
+    explicit streamingTopK(int k);
+
+    /**
+     * @brief Offers one value from the stream, counting through a policy.
+     */
+    template <typename CountPolicy>
+    void push(int value, CountPolicy counter);
+
+    /**
+     * @brief Offers one value from the stream, counting into sortResult.
+     */
+    void push(int value, sortResults& sortResult);
+
+    /**
+     * @brief Offers one value from the stream.
+     */
+    void push(int value);
+
+    /**
+     * @brief Number of values kept so far, at most k.
+     */
+    int size() const { return static_cast<int>(heap.size()); }
+
+    /**
+     * @brief Returns the kept values in ascending order, counting through a policy.
+     */
+    template <typename CountPolicy>
+    std::vector<int> sorted(CountPolicy counter) const;
+
+    /**
+     * @brief Returns the kept values in ascending order.
+     */
+    std::vector<int> sorted() const;
+
+private:
+    int k;
+    std::vector<int> heap;
+};
+
+/**
+ * @brief Sorts an array using an iterative bottom-up Heap Sort on a binary heap.
+ *
+ * Each sift descends to a leaf along the larger children and then climbs back up to
+ * where the sifted element belongs, saving about half the comparisons of heapSort.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void bottomUpHeapSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using a bottom-up Heap Sort on a d-ary heap.
+ *
+ * Wider heaps are shallower, trading comparisons per level for fewer levels and cache misses.
+ * With alignSiblings the heap is built in a cache-line aligned copy of the array, offset so
+ * that every node's children share one cache line when arity ints fit in a line (arity 4 or 16).
+ *
+ * @param arr           The array to be sorted.
+ * @param n             The number of elements in the array.
+ * @param arity         Children per node, at least 2.
+ * @param alignSiblings Whether to sort in an aligned copy so siblings share a cache line.
+ * @param sortResult    Struct to store the sorting performance metrics.
+ */
+void bottomUpHeapSort(int arr[], int n, int arity, bool alignSiblings, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Intro Sort (introspective Quick Sort).
+ *
+ * Quick Sort with a median-of-three pivot that switches to Heap Sort once the
+ * recursion depth exceeds 2 * log2(n), hands small ranges to Insertion Sort,
+ * and only recurses into the smaller partition.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void introSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using a branchless block-partition Quick Sort (pattern-defeating).
+ *
+ * Partitions by recording comparison outcomes as offsets in small blocks and exchanging
+ * the misplaced elements afterwards, so no branch depends on the data. Takes the pivot
+ * from a ninther on large ranges, finishes already partitioned ranges with a bounded
+ * insertion sort, groups elements equal to an earlier pivot, breaks up patterns that
+ * cause unbalanced partitions, and falls back to Heap Sort when they persist.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void blockQuickSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Merge Sort with a single preallocated scratch buffer.
+ *
+ * Allocates one n-sized buffer up front and ping-pongs between it and the array,
+ * so no allocations happen during the recursion.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void bufferedMergeSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Merge Sort with a caller-supplied scratch buffer.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param scratch    Scratch buffer of at least n elements; its contents are overwritten.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void bufferedMergeSort(int arr[], int n, int scratch[], sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using TimSort, an adaptive natural Merge Sort.
+ *
+ * Detects ascending and strictly descending runs, reverses the descending ones, and
+ * extends short runs with binary insertion. Runs are merged with galloping while the
+ * pending run lengths are kept balanced, so nearly sorted input sorts in close to
+ * O(n) time and any input in O(n log n). Stable, with a scratch buffer of n / 2 elements.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void timSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Intro Sort with the sorting network kernel as its base case.
+ *
+ * Ranges of up to 32 elements are sorted in registers by a bitonic network
+ * (AVX2 when the host supports it) instead of Insertion Sort.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void networkIntroSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using a bottom-up Merge Sort built on the sorting network kernels.
+ *
+ * Blocks of 32 elements are sorted by the bitonic network, then merged pairwise
+ * with the vectorized merge, ping-ponging through one scratch buffer.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void networkMergeSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using LSD Radix Sort on 8-bit digits.
+ *
+ * Makes no comparisons; negative values are handled by flipping the sign bit of each key.
+ * Passes where every key shares the same digit are skipped.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void radixSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using LSD Radix Sort with a caller-supplied scratch buffer.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param scratch    Scratch buffer of at least n elements; its contents are overwritten.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void radixSort(int arr[], int n, int scratch[], sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Merge Sort on every hardware thread.
+ *
+ * The recursive halves and the large merges run as tasks on a work-stealing pool.
+ * Each worker counts into its own slot, and the slots are summed into sortResult at the end.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void parallelMergeSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Merge Sort on a given number of threads.
+ *
+ * @param arr              The array to be sorted.
+ * @param n                The number of elements in the array.
+ * @param threadCount      Number of threads including the caller, 0 uses every hardware thread.
+ * @param sequentialCutoff Ranges at or below this size are sorted and merged by a single thread.
+ * @param sortResult       Struct to store the sorting performance metrics.
+ */
+void parallelMergeSort(int arr[], int n, int threadCount, int sequentialCutoff, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Intro Sort on every hardware thread.
+ *
+ * The smaller side of each partition runs as a task on a work-stealing pool.
+ * Each worker counts into its own slot, and the slots are summed into sortResult at the end.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param sortResult Struct to store the sorting performance metrics.
+ */
+void parallelQuickSort(int arr[], int n, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using Intro Sort on a given number of threads.
+ *
+ * @param arr              The array to be sorted.
+ * @param n                The number of elements in the array.
+ * @param threadCount      Number of threads including the caller, 0 uses every hardware thread.
+ * @param sequentialCutoff Ranges at or below this size are sorted by a single thread.
+ * @param sortResult       Struct to store the sorting performance metrics.
+ */
+void parallelQuickSort(int arr[], int n, int threadCount, int sequentialCutoff, sortResults& sortResult);
+
+/**
+ * @brief Sorts an array using the Insertion Sort algorithm, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void insertionSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the Quick Sort algorithm, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param low        The starting index of the array segment to sort.
+ * @param high       The ending index of the array segment to sort.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void quickSort(int arr[], int low, int high, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using Quick Sort with two-way or three-way partitioning, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param low        The starting index of the array segment to sort.
+ * @param high       The ending index of the array segment to sort.
+ * @param threeWay   Whether to partition three ways (<, ==, >) instead of two.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void quickSort(int arr[], int low, int high, bool threeWay, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the Merge Sort algorithm, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param left       The starting index of the array segment to sort.
+ * @param right      The ending index of the array segment to sort.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void mergeSort(int arr[], int left, int right, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the Heap Sort algorithm, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void heapSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Selects the k-th smallest element into arr[k] with introselect, counting through a policy.
+ *
+ * @param arr        The array to partially order.
+ * @param n          The number of elements in the array.
+ * @param k          The zero-based rank to select; out of range does nothing.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void nthElement(int arr[], int n, int k, CountPolicy counter);
+
+/**
+ * @brief Sorts the k smallest elements into arr[0..k - 1] with a bounded heap, counting through a policy.
+ *
+ * @param arr        The array to partially sort.
+ * @param n          The number of elements in the array.
+ * @param k          Number of smallest elements to sort, clamped to [0, n].
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void partialSort(int arr[], int n, int k, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the bottom-up binary Heap Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void bottomUpHeapSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the bottom-up d-ary Heap Sort, counting through a policy.
+ *
+ * @param arr           The array to be sorted.
+ * @param n             The number of elements in the array.
+ * @param arity         Children per node, at least 2.
+ * @param alignSiblings Whether to sort in an aligned copy so siblings share a cache line.
+ * @param counter       Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void bottomUpHeapSort(int arr[], int n, int arity, bool alignSiblings, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using Intro Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void introSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the block-partition Quick Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void blockQuickSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the buffered Merge Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void bufferedMergeSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the buffered Merge Sort with a caller-supplied scratch buffer, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param scratch    Scratch buffer of at least n elements; its contents are overwritten.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void bufferedMergeSort(int arr[], int n, int scratch[], CountPolicy counter);
+
+/**
+ * @brief Sorts an array using TimSort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void timSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the sorting network Intro Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void networkIntroSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the sorting network Merge Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void networkMergeSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using LSD Radix Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void radixSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using LSD Radix Sort with a caller-supplied scratch buffer, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param scratch    Scratch buffer of at least n elements; its contents are overwritten.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void radixSort(int arr[], int n, int scratch[], CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the parallel Merge Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void parallelMergeSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the parallel Merge Sort on a given number of threads, counting through a policy.
+ *
+ * @param arr              The array to be sorted.
+ * @param n                The number of elements in the array.
+ * @param threadCount      Number of threads including the caller, 0 uses every hardware thread.
+ * @param sequentialCutoff Ranges at or below this size are sorted and merged by a single thread.
+ * @param counter          Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void parallelMergeSort(int arr[], int n, int threadCount, int sequentialCutoff, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the parallel Intro Sort, counting through a policy.
+ *
+ * @param arr        The array to be sorted.
+ * @param n          The number of elements in the array.
+ * @param counter    Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void parallelQuickSort(int arr[], int n, CountPolicy counter);
+
+/**
+ * @brief Sorts an array using the parallel Intro Sort on a given number of threads, counting through a policy.
+ *
+ * @param arr              The array to be sorted.
+ * @param n                The number of elements in the array.
+ * @param threadCount      Number of threads including the caller, 0 uses every hardware thread.
+ * @param sequentialCutoff Ranges at or below this size are sorted by a single thread.
+ * @param counter          Counting policy (countingPolicy or noCountingPolicy).
+ */
+template <typename CountPolicy>
+void parallelQuickSort(int arr[], int n, int threadCount, int sequentialCutoff, CountPolicy counter);
\ No newline at end of file
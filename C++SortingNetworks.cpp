@@ -0,0 +1,263 @@
+#include "C++SortingNetworks.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORTING_NETWORKS_AVX2 1
+#include <immintrin.h>
+#else
+#define SORTING_NETWORKS_AVX2 0
+#endif
+
+// Bitonic sort of N elements: element i is compared with i ^ j, and blocks of size k
+// where (i & k) == 0 are sorted ascending, the others descending, so each pair of
+// neighbouring blocks forms a bitonic sequence for the next k
+
+// Padded network size for a block of n elements
+static int networkSize(int n) {
+    return n <= 8 ? 8 : n <= 16 ? 16 : 32;
+}
+
+unsigned long long networkSortComparators(int n) {
+    unsigned long long size = networkSize(n);
+    unsigned long long steps = 0;
+    for (unsigned long long k = 2; k <= size; k <<= 1) {
+        for (unsigned long long j = k / 2; j > 0; j >>= 1) {
+            steps++;
+        }
+    }
+    return steps * size / 2;
+}
+
+// Runs every step of the bitonic network for stage k, starting at distance j
+static void scalarBitonicStage(int buffer[], int size, int k, int j) {
+    for (; j > 0; j >>= 1) {
+        for (int i = 0; i < size; i++) {
+            int partner = i ^ j;
+            if (partner > i) {
+                int lo = std::min(buffer[i], buffer[partner]);
+                int hi = std::max(buffer[i], buffer[partner]);
+                bool ascending = (i & k) == 0;
+                buffer[i] = ascending ? lo : hi;
+                buffer[partner] = ascending ? hi : lo;
+            }
+        }
+    }
+}
+
+static void scalarSortBlock(int arr[], int n) {
+    int size = networkSize(n);
+    int buffer[NETWORK_BLOCK_SIZE];
+    std::memcpy(buffer, arr, n * sizeof(int));
+    std::fill(buffer + n, buffer + size, INT_MAX); // Padding sorts to the end
+
+    for (int k = 2; k <= size; k <<= 1) {
+        scalarBitonicStage(buffer, size, k, k / 2);
+    }
+
+    std::memcpy(arr, buffer, n * sizeof(int));
+}
+
+// Merges three sorted runs into dst, used for the tails left over by the vector merge
+static unsigned long long scalarMerge3(const int a[], int na, const int b[], int nb, const int c[], int nc, int dst[]) {
+    unsigned long long comparisons = 0;
+    int i = 0, j = 0, l = 0, k = 0;
+
+    while (i < na || j < nb || l < nc) {
+        // Pick the smallest head among the runs that still hold elements
+        int pick = -1;
+        int best = 0;
+        if (i < na) {
+            pick = 0;
+            best = a[i];
+        }
+        if (j < nb && (pick < 0 || (comparisons++, b[j] < best))) {
+            pick = 1;
+            best = b[j];
+        }
+        if (l < nc && (pick < 0 || (comparisons++, c[l] < best))) {
+            pick = 2;
+            best = c[l];
+        }
+
+        dst[k++] = best;
+        if (pick == 0) {
+            i++;
+        }
+        else if (pick == 1) {
+            j++;
+        }
+        else {
+            l++;
+        }
+    }
+
+    return comparisons;
+}
+
+static unsigned long long scalarMerge(const int a[], int na, const int b[], int nb, int dst[]) {
+    return scalarMerge3(a, na, b, nb, nullptr, 0, dst);
+}
+
+#if SORTING_NETWORKS_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Lanes where the bitonic step keeps the larger value: ((lane & j) != 0) != ((index & k) != 0)
+AVX2_TARGET static inline __m256i avx2TakeMax(int base, int j, int k) {
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i index = _mm256_add_epi32(lane, _mm256_set1_epi32(base));
+    __m256i lowHalf = _mm256_cmpeq_epi32(_mm256_and_si256(lane, _mm256_set1_epi32(j)), zero);
+    __m256i ascending = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(k)), zero);
+    return _mm256_xor_si256(lowHalf, ascending);
+}
+
+// Runs every step of the bitonic network for stage k over registers holding 8 elements each
+AVX2_TARGET static inline void avx2BitonicStage(__m256i regs[], int count, int k, int j) {
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (; j > 0; j >>= 1) {
+        if (j >= 8) {
+            // Partners sit in another register at the same lane
+            int registerDistance = j / 8;
+            for (int r = 0; r < count; r++) {
+                if ((r & registerDistance) == 0) {
+                    int partner = r | registerDistance;
+                    __m256i lo = _mm256_min_epi32(regs[r], regs[partner]);
+                    __m256i hi = _mm256_max_epi32(regs[r], regs[partner]);
+                    bool ascending = ((r * 8) & k) == 0;
+                    regs[r] = ascending ? lo : hi;
+                    regs[partner] = ascending ? hi : lo;
+                }
+            }
+        }
+        else {
+            // Partners sit in the same register, j lanes apart
+            __m256i partnerLane = _mm256_xor_si256(lane, _mm256_set1_epi32(j));
+            for (int r = 0; r < count; r++) {
+                __m256i partner = _mm256_permutevar8x32_epi32(regs[r], partnerLane);
+                __m256i lo = _mm256_min_epi32(regs[r], partner);
+                __m256i hi = _mm256_max_epi32(regs[r], partner);
+                regs[r] = _mm256_blendv_epi8(lo, hi, avx2TakeMax(r * 8, j, k));
+            }
+        }
+    }
+}
+
+AVX2_TARGET static void avx2SortBlock(int arr[], int n) {
+    int size = networkSize(n);
+    int count = size / 8;
+    int buffer[NETWORK_BLOCK_SIZE];
+    std::memcpy(buffer, arr, n * sizeof(int));
+    std::fill(buffer + n, buffer + size, INT_MAX); // Padding sorts to the end
+
+    __m256i regs[NETWORK_BLOCK_SIZE / 8];
+    for (int r = 0; r < count; r++) {
+        regs[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + r * 8));
+    }
+
+    for (int k = 2; k <= size; k <<= 1) {
+        avx2BitonicStage(regs, count, k, k / 2);
+    }
+
+    for (int r = 0; r < count; r++) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + r * 8), regs[r]);
+    }
+    std::memcpy(arr, buffer, n * sizeof(int));
+}
+
+// Merges two sorted registers: regs[0] receives the 8 smallest, regs[1] the 8 largest, both sorted
+AVX2_TARGET static inline void avx2MergeRegisters(__m256i regs[]) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    regs[1] = _mm256_permutevar8x32_epi32(regs[1], reverse); // Ascending then descending is bitonic
+    avx2BitonicStage(regs, 2, 16, 8);
+}
+
+AVX2_TARGET static unsigned long long avx2Merge(const int a[], int na, const int b[], int nb, int dst[]) {
+    if (na < 8 || nb < 8) {
+        return scalarMerge(a, na, b, nb, dst);
+    }
+
+    // Each register merge is a 16 element bitonic merge: 4 steps of 8 comparators
+    constexpr unsigned long long mergeComparators = 32;
+    unsigned long long comparisons = mergeComparators;
+
+    __m256i regs[2];
+    regs[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    regs[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    int i = 8, j = 8, k = 0;
+    avx2MergeRegisters(regs);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), regs[0]);
+    k += 8;
+
+    // Refill from the run with the smaller head, so everything written out is <= everything left
+    while (true) {
+        const int* next;
+        if (i < na && (j >= nb || (comparisons++, a[i] <= b[j]))) {
+            if (na - i < 8) {
+                break;
+            }
+            next = a + i;
+            i += 8;
+        }
+        else {
+            if (j >= nb || nb - j < 8) {
+                break;
+            }
+            next = b + j;
+            j += 8;
+        }
+
+        regs[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(next));
+        avx2MergeRegisters(regs);
+        comparisons += mergeComparators;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), regs[0]);
+        k += 8;
+    }
+
+    // The 8 carried elements still have to be merged with both tails
+    int carried[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(carried), regs[1]);
+    return comparisons + scalarMerge3(carried, 8, a + i, na - i, b + j, nb - j, dst + k);
+}
+
+static bool hostSupportsAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+// Runtime dispatch, chosen once on first use
+struct networkKernels {
+    void (*sortBlock)(int[], int);
+    unsigned long long (*merge)(const int[], int, const int[], int, int[]);
+    const char* name;
+};
+
+static const networkKernels& selectedKernels() {
+#if SORTING_NETWORKS_AVX2
+    static const networkKernels kernels = hostSupportsAvx2()
+        ? networkKernels{ avx2SortBlock, avx2Merge, "AVX2" }
+        : networkKernels{ scalarSortBlock, scalarMerge, "Scalar" };
+#else
+    static const networkKernels kernels = { scalarSortBlock, scalarMerge, "Scalar" };
+#endif
+    return kernels;
+}
+
+void networkSortBlock(int arr[], int n) {
+    if (n > 1) {
+        selectedKernels().sortBlock(arr, n);
+    }
+}
+
+unsigned long long networkMergeRuns(const int a[], int na, const int b[], int nb, int dst[]) {
+    return selectedKernels().merge(a, na, b, nb, dst);
+}
+
+const char* networkImplementationName() {
+    return selectedKernels().name;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+/**
+ * @brief Largest block the sorting network kernel sorts in one call.
+ */
+constexpr int NETWORK_BLOCK_SIZE = 32;
+
+/**
+ * @brief Sorts a small block in registers using a bitonic sorting network.
+ *
+ * The block is padded up to 8, 16, or 32 elements. The AVX2 kernel is used when the
+ * host supports it, otherwise a branchless scalar kernel runs the same network.
+ *
+ * @param arr        The block to be sorted.
+ * @param n          The number of elements in the block, at most NETWORK_BLOCK_SIZE.
+ */
+void networkSortBlock(int arr[], int n);
+
+/**
+ * @brief Number of comparators the sorting network runs for a block of n elements.
+ *
+ * @param n          The number of elements in the block, at most NETWORK_BLOCK_SIZE.
+ * @return           Comparator count of the padded network.
+ */
+unsigned long long networkSortComparators(int n);
+
+/**
+ * @brief Merges two sorted runs into dst, 8 elements at a time with a bitonic merge network.
+ *
+ * Falls back to a scalar merge when AVX2 is unavailable or a run is shorter than 8 elements.
+ *
+ * @param a          The first sorted run.
+ * @param na         The number of elements in a.
+ * @param b          The second sorted run.
+ * @param nb         The number of elements in b.
+ * @param dst        Output of na + nb elements; must not overlap a or b.
+ * @return           Number of comparisons (comparators and head comparisons) made.
+ */
+unsigned long long networkMergeRuns(const int a[], int na, const int b[], int nb, int dst[]);
+
+/**
+ * @brief Name of the sorting network implementation selected for this host.
+ *
+ * @return           "AVX2" or "Scalar".
+ */
+const char* networkImplementationName();
@@ -1,130 +1,551 @@
+#include "C++ExternalSort.hpp"
+#include "C++GenericSortingAlgorithms.hpp"
+#include "C++InputGenerators.hpp"
+#include "C++JobScheduler.hpp"
+#include "C++KeyIndexSort.hpp"
+#include "C++MappedFile.hpp"
+#include "C++PerfCounters.hpp"
 #include "C++SortingAlgorithms.hpp"
+#include "C++SortingNetworks.hpp"
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
 
 // Test iterations affects how many times each test is re-run for the averaged results to become more accurate
 constexpr int TEST_ITERATIONS = 3;
 
+// Untimed runs before each test, and the most runs an uninstrumented test may repeat for
+constexpr int WARMUP_ITERATIONS = 1;
+constexpr int MAX_TEST_ITERATIONS = 30;
+
+// Uninstrumented runs repeat until the 95% confidence interval is within this fraction of the mean
+constexpr double TARGET_RELATIVE_ERROR = 0.05;
+
 // Array size for testing the sorting algorithms
 constexpr int TEST_ARRAY_SIZE = 50000;
 
+// Default size range for --sweep, each size being SWEEP_SIZE_FACTOR times the last
+constexpr int SWEEP_MIN_SIZE = 16;
+constexpr int SWEEP_MAX_SIZE = 1 << 20;
+constexpr double SWEEP_SIZE_FACTOR = 2.0;
+
+// Small sizes are timed as a batch of independent arrays covering at least this many elements
+constexpr int SWEEP_BATCH_ELEMENTS = 1 << 16;
+
+// Insertion sort is quadratic, so the sweep skips it above this size
+constexpr int SWEEP_QUADRATIC_LIMIT = 1 << 15;
+
+// The time budget predicts a sort's run time from probes at this size and twice it
+constexpr int BUDGET_PROBE_SIZE = 1 << 12;
+constexpr int BUDGET_PROBE_RUNS = 3;
+
+// Children per node in the blocked heap sort, 4 aligned ints never straddle a cache line
+constexpr int BLOCKED_HEAP_ARITY = 4;
+
 // Formatting for the tables output to console
 constexpr int nameWidth = 20;
-constexpr int barWidth = 110;
+constexpr int barWidth = 120;
+
+// Default memory budget for --external-sort, in MiB
+constexpr int EXTERNAL_SORT_BUDGET_MIB = 256;
+
+// Benchmark settings, adjustable from the command line
+struct benchmarkSettings {
+    int warmupIterations = WARMUP_ITERATIONS;
+    int minIterations = TEST_ITERATIONS;
+    int maxIterations = MAX_TEST_ITERATIONS;
+    double targetRelativeError = TARGET_RELATIVE_ERROR;
+    std::string csvPath;
+    std::string jsonPath;
+    int arraySize = TEST_ARRAY_SIZE;
+    int sweepMinSize = SWEEP_MIN_SIZE;
+    int sweepMaxSize = SWEEP_MAX_SIZE;
+    double sweepSizeFactor = SWEEP_SIZE_FACTOR;
+    std::string sweepAlgorithms = "all";
+    bool hardwareCounters = false;
+    std::uint64_t seed = DEFAULT_INPUT_SEED;
+    int swaps = DEFAULT_NEARLY_SORTED_SWAPS;
+    std::string distributions = "ascending,descending,random,fewUnique";
+    int jobs = 1;
+    double timeBudget = 0;
+};
+benchmarkSettings settings;
+
+// Hardware counters opened on the main thread with --perf, telling which counters the host supports.
+// Every benchmark job opens its own, since counters only count the thread that opened them
+std::unique_ptr<perfCounters> hardwareCounters;
+
+// One algorithm's results for one input order, kept for the CSV and JSON reports
+struct scenarioResult {
+    std::string scenario;
+    int sort;
+    sortResults result;
+};
+std::vector<scenarioResult> recordedResults;
+
+// Reads benchmark flags into settings, returning false on an unknown or malformed flag
+bool parseBenchmarkSettings(int argc, char* argv[]);
+
+// Benchmarks each algorithm's performance on each of the given input distributions, as one job per pair
+void benchmarkSortingAlgorithms(const int TEST_ARRAY_SIZE, sortResults sortResults[], const int SORT_RESULTS_SIZE, const std::vector<int>& distributions);
+
+// Sorts a binary file of ints with the external sort and prints its metrics
+int runExternalSort(int argc, char* argv[]);
+
+// Benchmarks sorts on a file of raw little-endian ints mapped into memory, timing I/O and sorting separately
+int runInputFile(int argc, char* argv[]);
 
-// Benchmarks each algorithm's performance
-void benchmarkSortingAlgorithms(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[], const int SORT_RESULTS_SIZE);
+// Benchmarks sorts across a geometric range of array sizes, fitting scaling curves and reporting crossovers
+int runSizeSweep(int argc, char* argv[]);
 
-// Manipulates an array's elements to be in order, reverse order, or random order
-void setAscendingArray(int arr[], int size);
-void setDescendingArray(int arr[], int size);
-void setRandomArray(int arr[], int size);
+// Benchmarks sorting records by an int key directly against argsort and pair sort, at several record sizes
+int runRecordSort(int argc, char* argv[]);
+
+// Benchmarks selecting the k smallest elements against a full sort, for several k
+int runSelection(int argc, char* argv[]);
+
+// Benchmarks the streaming sorter on input arriving in batches against buffering it for one sort, timing the first result and the total
+int runStreamingSort(int argc, char* argv[]);
+
+// Resolves a comma-separated list of keys (or "all") into indices 0..count - 1, setting unknownKey and returning false on a key toKey never gives
+bool resolveKeys(const std::string& list, int count, std::string (*toKey)(int), std::vector<int>& indices, std::string& unknownKey);
 
 // Sets all values to 0 in sortResults[]
 void resetSortResults(sortResults sortResults[], const int SORT_RESULTS_SIZE);
 
 // Prints results of the benchmark's tests
-void printResults(sortResults sortResults[]);
+void printResults(sortResults sortResults[], const int SORT_RESULTS_SIZE);
 // Prints the best performing sort for each metric
 void printResultsAnalysis(sortResults sortResults[], const int SORT_RESULTS_SIZE);
+// Prints the spread of each sort's uninstrumented timings
+void printTimingStatistics(sortResults sortResults[], const int SORT_RESULTS_SIZE);
+// Prints each sort's hardware counters, marking counters the host could not open
+void printHardwareCounters(sortResults sortResults[], const int SORT_RESULTS_SIZE);
+
+// The sortResults field that holds a hardwareCounter
+unsigned long long& hardwareCount(sortResults& sortResult, int counter);
+
+// Keeps a scenario's results for the reports, and writes every kept result as CSV or JSON
+void recordResults(const std::string& scenario, sortResults sortResults[], const int SORT_RESULTS_SIZE);
+bool writeResultsCsv(const std::string& path);
+bool writeResultsJson(const std::string& path);
+
+// Least-squares fit of y = slope * x + intercept
+void fitLine(const std::vector<double>& x, const std::vector<double>& y, double& slope, double& intercept);
+
+// Half-width of the 95% confidence interval of a mean, and min/median/p95/stddev of a set of timings
+double confidenceHalfWidth(double stddev, unsigned long long samples);
+void computeTimingStatistics(std::vector<unsigned long long> durations, sortResults& sortResult);
 
 // Converts sort int into a string for printing
 std::string sortTypeToString(int sort);
+// Converts sort int into the short name used on the command line
+std::string sortTypeToKey(int sort);
 
 // Sets fewestComparisonSort, fewestMovementsSort, and fastestSort to the correct sort based on sortResults[]
 void compareComparisons(int& fewestComparisonSort, sortResults sortResults[], const int SORT_RESULTS_SIZE);
 void compareMovements(int& fewestMovementsSort, sortResults sortResults[], const int SORT_RESULTS_SIZE);
 void compareDuration(int& fastestSort, sortResults sortResults[], const int SORT_RESULTS_SIZE);
+void compareUninstrumentedDuration(int& fastestUninstrumentedSort, sortResults sortResults[], const int SORT_RESULTS_SIZE);
+
+// Tests one sorting algorithm on arrays filled with an inputDistribution, reading hardware counters through counters when not null
+void testSort(int sort, int distribution, int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult, perfCounters* counters);
+
+// Predicts one uninstrumented run of a sort on TEST_ARRAY_SIZE elements of a distribution, in nanoseconds
+double predictSortDuration(int sort, int distribution, const int TEST_ARRAY_SIZE);
+
+// Whether a sort was measured, rather than skipped for exceeding the time budget
+bool measured(const sortResults& sortResult);
 
-// Tests each sorting algorithm on an in order array
-void testInOrder(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[]);
-// Tests each sorting algorithm on a reverse order array
-void testReverseOrder(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[]);
-// Tests each sorting algorithm on a random order array
-void testRandomOrder(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[]);
+// Whether a sort starts threads of its own
+bool usesThreads(int sort);
 
-// Test function structure
-void testSort(void (*sort)(int[], int, sortResults&), void (*order)(int[], int), int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult);
-void testSort(void (*sort)(int[], int, int, sortResults&), void (*order)(int[], int), int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult);
+// Runs the generic iterator-based quickSort on an int array so it can be benchmarked like the other sorts
+template <typename CountPolicy>
+void genericQuickSort(int arr[], int n, CountPolicy counter) {
+    quickSort(arr, arr + n, std::less<>(), identityProjection(), counter);
+}
+void genericQuickSort(int arr[], int n, sortResults& sortResult);
+
+// Runs the bottom-up Heap Sort on a cache-aligned BLOCKED_HEAP_ARITY-ary heap so it can be benchmarked like the other sorts
+template <typename CountPolicy>
+void blockedHeapSort(int arr[], int n, CountPolicy counter) {
+    bottomUpHeapSort(arr, n, BLOCKED_HEAP_ARITY, true, counter);
+}
+void blockedHeapSort(int arr[], int n, sortResults& sortResult);
 
 // An enumeration for each sorting algorithm used in this program
 enum sortType {
     insertion,
     quick,
+    threeWayQuick,
     merge,
-    heap
+    tim,
+    heap,
+    bottomUpHeap,
+    blockedHeap,
+    bufferedMerge,
+    intro,
+    blockQuick,
+    parallelMerge,
+    parallelQuick,
+    radix,
+    networkIntro,
+    networkMerge,
+    genericQuick
+};
+
+// Number of sorting algorithms in sortType
+constexpr int SORT_RESULTS_SIZE = 17;
+
+// Every selected algorithm's results at one size of the sweep
+struct sweepPoint {
+    int size;
+    sortResults results[SORT_RESULTS_SIZE];
+    bool measured[SORT_RESULTS_SIZE];
 };
 
-// Creates a 50k element array, creates an array for algorithm performance metrics to be stored, and runs the benchmark to test, analyze, and print results
-int main() {
+// Sweeps the selected algorithms across the configured sizes, and prints or writes the sweep
+void sweepSizes(std::vector<sweepPoint>& points, const std::vector<int>& sorts);
+void printSweep(const std::vector<sweepPoint>& points, const std::vector<int>& sorts);
+bool writeSweepCsv(const std::string& path, const std::vector<sweepPoint>& points, const std::vector<int>& sorts);
+
+// Runs the sort selected by sortType on arr[0..n - 1]
+template <typename CountPolicy>
+void sortBySortType(int sort, int arr[], int n, CountPolicy counter) {
+    switch (sort) {
+    case sortType::insertion:   insertionSort(arr, n, counter); break;
+    case sortType::quick:       quickSort(arr, 0, n - 1, counter); break;
+    case sortType::threeWayQuick: quickSort(arr, 0, n - 1, true, counter); break;
+    case sortType::merge:       mergeSort(arr, 0, n - 1, counter); break;
+    case sortType::tim:         timSort(arr, n, counter); break;
+    case sortType::heap:        heapSort(arr, n, counter); break;
+    case sortType::bottomUpHeap: bottomUpHeapSort(arr, n, counter); break;
+    case sortType::blockedHeap: blockedHeapSort(arr, n, counter); break;
+    case sortType::bufferedMerge: bufferedMergeSort(arr, n, counter); break;
+    case sortType::intro:       introSort(arr, n, counter); break;
+    case sortType::blockQuick:  blockQuickSort(arr, n, counter); break;
+    case sortType::parallelMerge: parallelMergeSort(arr, n, counter); break;
+    case sortType::parallelQuick: parallelQuickSort(arr, n, counter); break;
+    case sortType::radix:       radixSort(arr, n, counter); break;
+    case sortType::networkIntro: networkIntroSort(arr, n, counter); break;
+    case sortType::networkMerge: networkMergeSort(arr, n, counter); break;
+    case sortType::genericQuick: genericQuickSort(arr, n, counter); break;
+    }
+}
+
+// Creates a 50k element array (or --size elements), creates an array for algorithm performance metrics to be stored, and runs the benchmark to test, analyze, and print results
+// Usage: main [--size N] [--distributions all|a,b,...] [--swaps K] [--seed N] [--jobs N] [--time-budget SECONDS] [--perf] [--warmup N] [--min-runs N] [--max-runs N] [--target-error FRACTION] [--csv PATH] [--json PATH]
+//        main --sweep [--min-size N] [--max-size N] [--size-factor F] [--algorithms all|a,b,...] [--seed N] [--min-runs N] [--csv PATH]
+//        main --records [--size N] [--seed N] [--warmup N] [--min-runs N]
+//        main --select [--size N] [--seed N] [--warmup N] [--min-runs N]
+//        main --stream [--size N] [--seed N] [--warmup N] [--min-runs N]
+//        main --external-sort <input> <output> [memoryMiB] [tempDirectory]
+//        main --input-file <input> [algorithm|all] [output]
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--external-sort") {
+        return runExternalSort(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--input-file") {
+        return runInputFile(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        return runSizeSweep(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--records") {
+        return runRecordSort(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--select") {
+        return runSelection(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--stream") {
+        return runStreamingSort(argc, argv);
+    }
+    if (!parseBenchmarkSettings(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [--size N] [--distributions all|a,b,...] [--swaps K] [--seed N] [--jobs N] [--time-budget SECONDS] [--perf] [--warmup N] [--min-runs N] [--max-runs N] [--target-error FRACTION] [--csv PATH] [--json PATH]\n";
+        return 1;
+    }
+
+    std::vector<int> distributions;
+    std::string unknownKey;
+    if (!resolveKeys(settings.distributions, INPUT_DISTRIBUTION_COUNT, inputDistributionToKey, distributions, unknownKey)) {
+        std::cerr << "Unknown distribution: " << unknownKey << "\n";
+        return 1;
+    }
+
+    if (settings.hardwareCounters) {
+        hardwareCounters = std::make_unique<perfCounters>();
+        if (!hardwareCounters->anyAvailable()) {
+            std::cerr << "Hardware counters are unavailable (perf_event_open refused, see /proc/sys/kernel/perf_event_paranoid), continuing without them\n";
+            hardwareCounters.reset();
+        }
+    }
+
     // Holds the performance metrics of each sorting algorithm
-    constexpr int SORT_RESULTS_SIZE = 4;
     sortResults sortResults[SORT_RESULTS_SIZE];
     // Sets all values to 0
     resetSortResults(sortResults, SORT_RESULTS_SIZE);
 
-    int testArray[TEST_ARRAY_SIZE];
-    // Populates the array with values
-    setAscendingArray(testArray, TEST_ARRAY_SIZE);
+    benchmarkSortingAlgorithms(settings.arraySize, sortResults, SORT_RESULTS_SIZE, distributions);
 
-    benchmarkSortingAlgorithms(testArray, TEST_ARRAY_SIZE, sortResults, SORT_RESULTS_SIZE);
+    if (!settings.csvPath.empty() && !writeResultsCsv(settings.csvPath)) {
+        std::cerr << "Cannot write " << settings.csvPath << "\n";
+        return 1;
+    }
+    if (!settings.jsonPath.empty() && !writeResultsJson(settings.jsonPath)) {
+        std::cerr << "Cannot write " << settings.jsonPath << "\n";
+        return 1;
+    }
 }
 
-void benchmarkSortingAlgorithms(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[], const int SORT_RESULTS_SIZE) {
-    std::cout << "The following values are the average results over " << TEST_ITERATIONS << " simulation(s)\n\n";
-    std::cout << "Experimental Results - Input List: Array Size = " << TEST_ARRAY_SIZE << "\n\n\n";
+void benchmarkSortingAlgorithms(const int TEST_ARRAY_SIZE, sortResults sortResults[], const int SORT_RESULTS_SIZE, const std::vector<int>& distributions) {
+    int workers = settings.jobs > 0 ? settings.jobs : availableCpuCount();
 
-    // Print In Order test results
-    testInOrder(testArray, TEST_ARRAY_SIZE, sortResults);
-    std::cout << "IN ORDER (ASCENDING):\n\n";
-    printResults(sortResults);
-    printResultsAnalysis(sortResults, SORT_RESULTS_SIZE);
+    std::cout << "Comparisons, Movements, and Total Time are averaged over " << settings.minIterations << " instrumented simulation(s)\n";
+    std::cout << "Uninstrumented timings follow " << settings.warmupIterations << " warmup run(s) and repeat until the 95% confidence interval is within "
+        << settings.targetRelativeError * 100 << "% of the mean (" << settings.minIterations << " to " << settings.maxIterations << " runs)\n";
+    if (workers == 1) {
+        std::cout << "Scheduling: serial, one job at a time on the main thread\n";
+    }
+    else {
+        std::cout << "Scheduling: " << workers << " pinned worker threads, concurrent jobs share memory bandwidth and caches, use --jobs 1 for quiet timings\n";
+        std::cout << "            Parallel sorts run afterwards on the main thread, one at a time, since their threads would inherit a worker's single CPU\n";
+    }
+    if (settings.timeBudget > 0) {
+        std::cout << "Time Budget: " << settings.timeBudget << " s per job, predicted from probes at " << BUDGET_PROBE_SIZE << " and " << 2 * BUDGET_PROBE_SIZE << " elements\n";
+    }
+    std::cout << "\n";
+    std::cout << "Experimental Results - Input List: Array Size = " << TEST_ARRAY_SIZE << ", Seed = " << settings.seed << "\n";
+    std::cout << "Sorting Network Kernel: " << networkImplementationName() << "\n\n\n";
+
+    // One job per (algorithm, distribution), each with its own array and result slot.
+    // Jobs are numbered algorithm first so the slowest algorithms, which come first in sortType, start first
+    const int distributionCount = static_cast<int>(distributions.size());
+    std::vector<::sortResults> jobResults(static_cast<std::size_t>(distributionCount) * SORT_RESULTS_SIZE);
+    auto runJob = [&](int job) {
+        int sort = job / distributionCount, distribution = distributions[job % distributionCount];
+        ::sortResults& sortResult = jobResults[job];
+        resetSortResults(&sortResult, 1);
+
+        // A job predicted to overrun its budget is skipped and left unmeasured
+        int runs = settings.warmupIterations + 2 * settings.minIterations;
+        if (settings.timeBudget > 0 && predictSortDuration(sort, distribution, TEST_ARRAY_SIZE) * runs > settings.timeBudget * 1e9) {
+            return;
+        }
 
-    resetSortResults(sortResults, SORT_RESULTS_SIZE);
+        std::vector<int> testArray(TEST_ARRAY_SIZE);
+        std::unique_ptr<perfCounters> counters = hardwareCounters ? std::make_unique<perfCounters>() : nullptr;
+        testSort(sort, distribution, testArray.data(), TEST_ARRAY_SIZE, sortResult, counters.get());
+    };
 
-    // Print Reverse Order test results
-    testReverseOrder(testArray, TEST_ARRAY_SIZE, sortResults);
-    std::cout << "\nREVERSE ORDER (DESCENDING):\n\n";
-    printResults(sortResults);
-    printResultsAnalysis(sortResults, SORT_RESULTS_SIZE);
+    // Threads inherit their creator's affinity, so a parallel sort started on a pinned worker would
+    // run all of its threads on that worker's CPU. Those jobs wait for the others and run unpinned
+    std::vector<int> pooledJobs, exclusiveJobs;
+    for (int job = 0; job < distributionCount * SORT_RESULTS_SIZE; job++) {
+        (workers > 1 && usesThreads(job / distributionCount) ? exclusiveJobs : pooledJobs).push_back(job);
+    }
+    runJobs(static_cast<int>(pooledJobs.size()), workers, [&](int i) { runJob(pooledJobs[i]); });
+    runJobs(static_cast<int>(exclusiveJobs.size()), 1, [&](int i) { runJob(exclusiveJobs[i]); });
 
-    resetSortResults(sortResults, SORT_RESULTS_SIZE);
+    for (int i = 0; i < distributionCount; i++) {
+        for (int sort = 0; sort < SORT_RESULTS_SIZE; sort++) {
+            sortResults[sort] = jobResults[static_cast<std::size_t>(sort) * distributionCount + i];
+        }
 
-    // Print Random Order test results
-    testRandomOrder(testArray, TEST_ARRAY_SIZE, sortResults);
-    std::cout << "\nRANDOMIZED ORDER:\n\n";
-    printResults(sortResults);
-    printResultsAnalysis(sortResults, SORT_RESULTS_SIZE);
+        // Print the distribution's test results under an upper case heading
+        std::string heading = inputDistributionToString(distributions[i]);
+        std::transform(heading.begin(), heading.end(), heading.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        std::cout << (i > 0 ? "\n" : "") << heading << ":\n\n";
+        printResults(sortResults, SORT_RESULTS_SIZE);
+        printResultsAnalysis(sortResults, SORT_RESULTS_SIZE);
+        printTimingStatistics(sortResults, SORT_RESULTS_SIZE);
+        printHardwareCounters(sortResults, SORT_RESULTS_SIZE);
+        recordResults(inputDistributionToKey(distributions[i]), sortResults, SORT_RESULTS_SIZE);
+    }
 }
 
-// Set array to be in order
-void setAscendingArray(int arr[], int size) {
-    for (int i = 0; i < size; i++) {
-        arr[i] = i;
+int runExternalSort(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " --external-sort <input> <output> [memoryMiB] [tempDirectory]\n";
+        return 1;
     }
+
+    std::string inputPath = argv[2];
+    std::string outputPath = argv[3];
+    std::string tempDirectory = argc > 5 ? argv[5] : "";
+
+    // The budget must be a whole number of MiB, without a sign or trailing characters
+    unsigned long long memoryMiB = EXTERNAL_SORT_BUDGET_MIB;
+    if (argc > 4) {
+        std::string memoryArgument = argv[4];
+        std::size_t parsed = 0;
+        try {
+            memoryMiB = std::isdigit(static_cast<unsigned char>(memoryArgument[0])) ? std::stoull(memoryArgument, &parsed) : 0;
+        }
+        catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != memoryArgument.size() || memoryMiB > SIZE_MAX / (1024 * 1024)) {
+            std::cerr << "Invalid memory budget: " << memoryArgument << "\n";
+            std::cerr << "Usage: " << argv[0] << " --external-sort <input> <output> [memoryMiB] [tempDirectory]\n";
+            return 1;
+        }
+    }
+    std::size_t memoryBudget = static_cast<std::size_t>(memoryMiB) * 1024 * 1024;
+
+    sortResults sortResult{};
+    auto startTime = std::chrono::high_resolution_clock::now();
+    try {
+        externalSort(inputPath, outputPath, memoryBudget, tempDirectory, introSort, sortResult);
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    sortResult.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+
+    std::cout << "External Sort: " << inputPath << " -> " << outputPath << " (memory budget " << memoryBudget / (1024 * 1024) << " MiB)\n";
+    std::cout << std::left << std::setw(nameWidth) << "Comparisons:" << sortResult.comparisons << "\n";
+    std::cout << std::left << std::setw(nameWidth) << "Movements:" << sortResult.movements << "\n";
+    std::cout << std::left << std::setw(nameWidth) << "Total Time (ns):" << sortResult.duration << "\n";
+    return 0;
 }
 
-// Set array to be reverse order
-void setDescendingArray(int arr[], int size) {
-    for (int i = 0; i < size; i++) {
-        arr[i] = (size - 1) - i;
+int runInputFile(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " --input-file <input> [algorithm|all] [output]\n";
+        return 1;
+    }
+
+    std::string inputPath = argv[2];
+    std::string algorithm = argc > 3 ? argv[3] : "all";
+    std::string outputPath = argc > 4 ? argv[4] : "";
+
+    int firstSort = 0, lastSort = SORT_RESULTS_SIZE - 1;
+    if (algorithm != "all") {
+        firstSort = SORT_RESULTS_SIZE;
+        for (int sort = 0; sort < SORT_RESULTS_SIZE; sort++) {
+            if (sortTypeToKey(sort) == algorithm) {
+                firstSort = lastSort = sort;
+            }
+        }
+        if (firstSort == SORT_RESULTS_SIZE) {
+            std::cerr << "Unknown algorithm: " << algorithm << "\n";
+            return 1;
+        }
+    }
+
+    // Formatting
+    constexpr int numWidth = 25;
+
+    std::cout << "Input File: " << inputPath << (outputPath.empty() ? " (private copy-on-write mapping)" : " -> " + outputPath + " (shared output mapping)") << "\n\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    std::cout << std::left << std::setw(nameWidth) << "Sort Type"
+        << std::right << std::setw(numWidth) << "Elements"
+        << std::setw(numWidth) << "I/O Time (ns)"
+        << std::setw(numWidth) << "Sort Time (ns)"
+        << std::setw(numWidth) << "Sorted" << "\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+
+    for (int sort = firstSort; sort <= lastSort; sort++) {
+        try {
+            // Every sort gets a fresh mapping, so mapping and faulting in the pages is part of its I/O time
+            auto ioStart = std::chrono::high_resolution_clock::now();
+            std::unique_ptr<mappedIntArray> mapping = outputPath.empty()
+                ? std::make_unique<mappedIntArray>(inputPath)
+                : std::make_unique<mappedIntArray>(inputPath, outputPath);
+            auto ioEnd = std::chrono::high_resolution_clock::now();
+            unsigned long long ioDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(ioEnd - ioStart).count();
+
+            if (mapping->size() > static_cast<std::size_t>(INT_MAX)) {
+                std::cerr << "Input has more than " << INT_MAX << " ints, use --external-sort instead\n";
+                return 1;
+            }
+            int n = static_cast<int>(mapping->size());
+
+            auto sortStart = std::chrono::high_resolution_clock::now();
+            sortBySortType(sort, mapping->data(), n, noCountingPolicy{});
+            auto sortEnd = std::chrono::high_resolution_clock::now();
+            unsigned long long sortDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(sortEnd - sortStart).count();
+
+            bool sorted = std::is_sorted(mapping->data(), mapping->data() + n);
+
+            // Writing an output mapping back to disk is I/O too
+            ioStart = std::chrono::high_resolution_clock::now();
+            mapping->flush();
+            mapping.reset();
+            ioEnd = std::chrono::high_resolution_clock::now();
+            ioDuration += std::chrono::duration_cast<std::chrono::nanoseconds>(ioEnd - ioStart).count();
+
+            std::cout << std::left << std::setw(nameWidth) << sortTypeToString(sort)
+                << std::right << std::setw(numWidth) << n
+                << std::setw(numWidth) << ioDuration
+                << std::setw(numWidth) << sortDuration
+                << std::setw(numWidth) << (sorted ? "Yes" : "No") << "\n";
+        }
+        catch (const std::exception& error) {
+            std::cerr << error.what() << "\n";
+            return 1;
+        }
     }
+
+    std::cout << std::string(barWidth, '-') << "\n";
+    return 0;
 }
 
-// Set array to be random order
-void setRandomArray(int arr[], int size) {
-    // Seed the random number generator with the current time
-    std::srand(static_cast<unsigned>(std::time(0)));
+int runSizeSweep(int argc, char* argv[]) {
+    // Flags follow --sweep, so parse as if it were the program name
+    if (!parseBenchmarkSettings(argc - 1, argv + 1)) {
+        std::cerr << "Usage: " << argv[0] << " --sweep [--min-size N] [--max-size N] [--size-factor F] [--algorithms all|a,b,...] [--seed N] [--min-runs N] [--csv PATH]\n";
+        return 1;
+    }
+
+    std::vector<int> sorts;
+    std::string unknownKey;
+    if (!resolveKeys(settings.sweepAlgorithms, SORT_RESULTS_SIZE, sortTypeToKey, sorts, unknownKey)) {
+        std::cerr << "Unknown algorithm: " << unknownKey << "\n";
+        return 1;
+    }
 
-    // Fisher-Yates shuffle algorithm
-    for (int i = size - 1; i > 0; i--) {
-        // Generate a random index from 0 to i
-        int j = std::rand() % (i + 1);
+    std::vector<sweepPoint> points;
+    sweepSizes(points, sorts);
+    printSweep(points, sorts);
 
-        // Swap arr[i] with arr[j]
-        std::swap(arr[i], arr[j]);
+    if (!settings.csvPath.empty() && !writeSweepCsv(settings.csvPath, points, sorts)) {
+        std::cerr << "Cannot write " << settings.csvPath << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+bool resolveKeys(const std::string& list, int count, std::string (*toKey)(int), std::vector<int>& indices, std::string& unknownKey) {
+    std::string keys = list + ",";
+    for (std::size_t start = 0, end; (end = keys.find(',', start)) != std::string::npos; start = end + 1) {
+        std::string key = keys.substr(start, end - start);
+        bool found = false;
+        for (int index = 0; index < count; index++) {
+            if (key == "all" || toKey(index) == key) {
+                indices.push_back(index);
+                found = true;
+            }
+        }
+        if (!found) {
+            unknownKey = key;
+            return false;
+        }
     }
+    return true;
 }
 
 void resetSortResults(sortResults sortResults[], const int SORT_RESULTS_SIZE) {
@@ -133,12 +554,21 @@ void resetSortResults(sortResults sortResults[], const int SORT_RESULTS_SIZE) {
         sortResults[i].comparisons = 0;
         sortResults[i].movements = 0;
         sortResults[i].duration = 0;
+        sortResults[i].uninstrumentedDuration = 0;
+        sortResults[i].iterations = 0;
+        sortResults[i].minDuration = 0;
+        sortResults[i].medianDuration = 0;
+        sortResults[i].p95Duration = 0;
+        sortResults[i].stddevDuration = 0;
+        for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+            hardwareCount(sortResults[i], counter) = 0;
+        }
     }
 }
 
-void printResults(sortResults sortResults[]) {
+void printResults(sortResults sortResults[], const int SORT_RESULTS_SIZE) {
     // Formatting
-    constexpr int numWidth = 30;
+    constexpr int numWidth = 25;
 
     // Print a bar
     std::cout << std::string(barWidth, '-') << "\n";
@@ -147,31 +577,25 @@ void printResults(sortResults sortResults[]) {
     std::cout << std::left << std::setw(nameWidth) << "Sort Type"
         << std::right << std::setw(numWidth) << "Comparisons"
         << std::setw(numWidth) << "Movements"
-        << std::setw(numWidth) << "Total Time (ns)" << "\n";
+        << std::setw(numWidth) << "Total Time (ns)"
+        << std::setw(numWidth) << "Uninstrumented (ns)" << "\n";
 
     // Print a bar
     std::cout << std::string(barWidth, '-') << "\n";
 
     // Print results for each sorting algorithm
-    std::cout << std::left << std::setw(nameWidth) << "Insertion Sort"
-        << std::right << std::setw(numWidth) << sortResults[sortType::insertion].comparisons
-        << std::setw(numWidth) << sortResults[sortType::insertion].movements
-        << std::setw(numWidth) << sortResults[sortType::insertion].duration << "\n";
-
-    std::cout << std::left << std::setw(nameWidth) << "Quick Sort"
-        << std::right << std::setw(numWidth) << sortResults[sortType::quick].comparisons
-        << std::setw(numWidth) << sortResults[sortType::quick].movements
-        << std::setw(numWidth) << sortResults[sortType::quick].duration << "\n";
-
-    std::cout << std::left << std::setw(nameWidth) << "Merge Sort"
-        << std::right << std::setw(numWidth) << sortResults[sortType::merge].comparisons
-        << std::setw(numWidth) << sortResults[sortType::merge].movements
-        << std::setw(numWidth) << sortResults[sortType::merge].duration << "\n";
-
-    std::cout << std::left << std::setw(nameWidth) << "Heap Sort"
-        << std::right << std::setw(numWidth) << sortResults[sortType::heap].comparisons
-        << std::setw(numWidth) << sortResults[sortType::heap].movements
-        << std::setw(numWidth) << sortResults[sortType::heap].duration << "\n\n";
+    for (int sort = 0; sort < SORT_RESULTS_SIZE; sort++) {
+        if (!measured(sortResults[sort])) {
+            std::cout << std::left << std::setw(nameWidth) << sortTypeToString(sort) << std::right << std::setw(numWidth) << "skipped" << "\n";
+            continue;
+        }
+        std::cout << std::left << std::setw(nameWidth) << sortTypeToString(sort)
+            << std::right << std::setw(numWidth) << sortResults[sort].comparisons
+            << std::setw(numWidth) << sortResults[sort].movements
+            << std::setw(numWidth) << sortResults[sort].duration
+            << std::setw(numWidth) << sortResults[sort].uninstrumentedDuration << "\n";
+    }
+    std::cout << "\n";
 
     // Print a bar
     std::cout << std::string(barWidth, '-') << "\n";
@@ -179,15 +603,17 @@ void printResults(sortResults sortResults[]) {
 
 void printResultsAnalysis(sortResults sortResults[], const int SORT_RESULTS_SIZE) {
     // Calculate and set which sorts are performing best
-    int fewestComparisonSort, fewestMovementsSort, fastestSort;
+    int fewestComparisonSort, fewestMovementsSort, fastestSort, fastestUninstrumentedSort;
     compareComparisons(fewestComparisonSort, sortResults, SORT_RESULTS_SIZE);
     compareMovements(fewestMovementsSort, sortResults, SORT_RESULTS_SIZE);
     compareDuration(fastestSort, sortResults, SORT_RESULTS_SIZE);
+    compareUninstrumentedDuration(fastestUninstrumentedSort, sortResults, SORT_RESULTS_SIZE);
 
     // Converting from the sort int to std::string for printing
     std::string fewestComparisonSortName = sortTypeToString(fewestComparisonSort);
     std::string fewestMovementsSortName = sortTypeToString(fewestMovementsSort);
     std::string fastestSortName = sortTypeToString(fastestSort);
+    std::string fastestUninstrumentedSortName = sortTypeToString(fastestUninstrumentedSort);
 
     // Formatting
     constexpr int numWidth = 10;
@@ -208,16 +634,260 @@ void printResultsAnalysis(sortResults sortResults[], const int SORT_RESULTS_SIZE
         << std::right << std::setw(numWidth) << sortResults[fastestSort].duration
         << " Total Time (ns)\n";
 
+    std::cout << std::left << std::setw(nameWidth) << "Fastest Production:"
+        << std::left << std::setw(nameWidth) << fastestUninstrumentedSortName
+        << std::right << std::setw(numWidth) << sortResults[fastestUninstrumentedSort].uninstrumentedDuration
+        << " Uninstrumented (ns)\n";
+
     // Print a bar
     std::cout << std::string(barWidth, '-') << "\n\n";
 }
 
+void printTimingStatistics(sortResults sortResults[], const int SORT_RESULTS_SIZE) {
+    // Formatting
+    constexpr int numWidth = 14;
+
+    std::cout << "Uninstrumented Timing Statistics (ns):\n";
+    std::cout << std::left << std::setw(nameWidth) << "Sort Type"
+        << std::right << std::setw(numWidth - 6) << "Runs"
+        << std::setw(numWidth) << "Min"
+        << std::setw(numWidth) << "Median"
+        << std::setw(numWidth) << "Mean"
+        << std::setw(numWidth) << "p95"
+        << std::setw(numWidth) << "Stddev"
+        << std::setw(numWidth) << "95% CI +/-" << "\n";
+
+    for (int sort = 0; sort < SORT_RESULTS_SIZE; sort++) {
+        if (!measured(sortResults[sort])) {
+            continue;
+        }
+        std::cout << std::left << std::setw(nameWidth) << sortTypeToString(sort)
+            << std::right << std::setw(numWidth - 6) << sortResults[sort].iterations
+            << std::setw(numWidth) << sortResults[sort].minDuration
+            << std::setw(numWidth) << sortResults[sort].medianDuration
+            << std::setw(numWidth) << sortResults[sort].uninstrumentedDuration
+            << std::setw(numWidth) << sortResults[sort].p95Duration
+            << std::setw(numWidth) << static_cast<unsigned long long>(sortResults[sort].stddevDuration)
+            << std::setw(numWidth) << static_cast<unsigned long long>(confidenceHalfWidth(sortResults[sort].stddevDuration, sortResults[sort].iterations)) << "\n";
+    }
+
+    // Print a bar
+    std::cout << std::string(barWidth, '-') << "\n\n";
+}
+
+void printHardwareCounters(sortResults sortResults[], const int SORT_RESULTS_SIZE) {
+    if (!hardwareCounters) {
+        return;
+    }
+
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << "Hardware Counters (mean per uninstrumented run, calling thread only):\n";
+    std::cout << std::left << std::setw(nameWidth) << "Sort Type" << std::right;
+    for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+        std::cout << std::setw(numWidth) << hardwareCounterName(counter);
+    }
+    std::cout << std::setw(numWidth - 8) << "IPC" << "\n";
+
+    for (int sort = 0; sort < SORT_RESULTS_SIZE; sort++) {
+        if (!measured(sortResults[sort])) {
+            continue;
+        }
+        std::cout << std::left << std::setw(nameWidth) << sortTypeToString(sort) << std::right;
+        for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+            if (hardwareCounters->available(counter)) {
+                std::cout << std::setw(numWidth) << hardwareCount(sortResults[sort], counter);
+            }
+            else {
+                std::cout << std::setw(numWidth) << "n/a";
+            }
+        }
+        if (hardwareCounters->available(counterCycles) && hardwareCounters->available(counterInstructions) && sortResults[sort].cycles > 0) {
+            std::cout << std::setw(numWidth - 8) << std::fixed << std::setprecision(2)
+                << static_cast<double>(sortResults[sort].instructions) / sortResults[sort].cycles << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        else {
+            std::cout << std::setw(numWidth - 8) << "n/a" << "\n";
+        }
+    }
+
+    // Print a bar
+    std::cout << std::string(barWidth, '-') << "\n\n";
+}
+
+unsigned long long& hardwareCount(sortResults& sortResult, int counter) {
+    switch (counter) {
+    case counterCycles:       return sortResult.cycles;
+    case counterInstructions: return sortResult.instructions;
+    case counterL1dMisses:    return sortResult.l1dMisses;
+    case counterLlcMisses:    return sortResult.llcMisses;
+    default:                  return sortResult.branchMisses;
+    }
+}
+
+void recordResults(const std::string& scenario, sortResults sortResults[], const int SORT_RESULTS_SIZE) {
+    for (int sort = 0; sort < SORT_RESULTS_SIZE; sort++) {
+        if (!measured(sortResults[sort])) {
+            continue; // Skipped sorts have nothing to report
+        }
+        recordedResults.push_back(scenarioResult{ scenario, sort, sortResults[sort] });
+    }
+}
+
+bool writeResultsCsv(const std::string& path) {
+    std::ofstream file(path);
+    file << "scenario,algorithm,array_size,seed,comparisons,movements,instrumented_mean_ns,runs,mean_ns,min_ns,median_ns,p95_ns,stddev_ns,ci95_ns,cycles,instructions,l1d_misses,llc_misses,branch_misses\n";
+    for (const scenarioResult& record : recordedResults) {
+        const sortResults& result = record.result;
+        file << record.scenario << ',' << sortTypeToKey(record.sort) << ',' << settings.arraySize << ',' << settings.seed << ','
+            << result.comparisons << ',' << result.movements << ',' << result.duration << ','
+            << result.iterations << ',' << result.uninstrumentedDuration << ',' << result.minDuration << ','
+            << result.medianDuration << ',' << result.p95Duration << ',' << result.stddevDuration << ','
+            << confidenceHalfWidth(result.stddevDuration, result.iterations) << ',' << result.cycles << ','
+            << result.instructions << ',' << result.l1dMisses << ',' << result.llcMisses << ',' << result.branchMisses << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool writeResultsJson(const std::string& path) {
+    std::ofstream file(path);
+    file << "{\n  \"array_size\": " << settings.arraySize << ",\n  \"seed\": " << settings.seed << ",\n  \"network_kernel\": \"" << networkImplementationName() << "\",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < recordedResults.size(); i++) {
+        const scenarioResult& record = recordedResults[i];
+        const sortResults& result = record.result;
+        file << "    {\"scenario\": \"" << record.scenario << "\", \"algorithm\": \"" << sortTypeToKey(record.sort) << "\""
+            << ", \"comparisons\": " << result.comparisons << ", \"movements\": " << result.movements
+            << ", \"instrumented_mean_ns\": " << result.duration << ", \"runs\": " << result.iterations
+            << ", \"mean_ns\": " << result.uninstrumentedDuration << ", \"min_ns\": " << result.minDuration
+            << ", \"median_ns\": " << result.medianDuration << ", \"p95_ns\": " << result.p95Duration
+            << ", \"stddev_ns\": " << result.stddevDuration
+            << ", \"ci95_ns\": " << confidenceHalfWidth(result.stddevDuration, result.iterations)
+            << ", \"cycles\": " << result.cycles << ", \"instructions\": " << result.instructions
+            << ", \"l1d_misses\": " << result.l1dMisses << ", \"llc_misses\": " << result.llcMisses
+            << ", \"branch_misses\": " << result.branchMisses << "}"
+            << (i + 1 < recordedResults.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+bool parseBenchmarkSettings(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--perf") {
+            settings.hardwareCounters = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false; // Every flag takes a value
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (flag == "--size") {
+                settings.arraySize = std::stoi(value);
+            }
+            else if (flag == "--min-size") {
+                settings.sweepMinSize = std::stoi(value);
+            }
+            else if (flag == "--max-size") {
+                settings.sweepMaxSize = std::stoi(value);
+            }
+            else if (flag == "--size-factor") {
+                settings.sweepSizeFactor = std::stod(value);
+            }
+            else if (flag == "--distributions") {
+                settings.distributions = value;
+            }
+            else if (flag == "--jobs") {
+                settings.jobs = std::stoi(value);
+            }
+            else if (flag == "--time-budget") {
+                settings.timeBudget = std::stod(value);
+            }
+            else if (flag == "--swaps") {
+                settings.swaps = std::stoi(value);
+            }
+            else if (flag == "--seed") {
+                settings.seed = std::stoull(value, nullptr, 0);
+            }
+            else if (flag == "--algorithms") {
+                settings.sweepAlgorithms = value;
+            }
+            else if (flag == "--warmup") {
+                settings.warmupIterations = std::stoi(value);
+            }
+            else if (flag == "--min-runs") {
+                settings.minIterations = std::stoi(value);
+            }
+            else if (flag == "--max-runs") {
+                settings.maxIterations = std::stoi(value);
+            }
+            else if (flag == "--target-error") {
+                settings.targetRelativeError = std::stod(value);
+            }
+            else if (flag == "--csv") {
+                settings.csvPath = value;
+            }
+            else if (flag == "--json") {
+                settings.jsonPath = value;
+            }
+            else {
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    return settings.warmupIterations >= 0 && settings.minIterations >= 1 && settings.jobs >= 0 && settings.timeBudget >= 0 && (settings.swaps >= 0 || settings.swaps == DEFAULT_NEARLY_SORTED_SWAPS) && settings.maxIterations >= settings.minIterations
+        && settings.arraySize >= 1 && settings.sweepMinSize >= 1 && settings.sweepMaxSize >= settings.sweepMinSize && settings.sweepSizeFactor > 1;
+}
+
+std::string sortTypeToKey(int sort) {
+    switch (sort) {
+    case sortType::insertion:   return "insertion";
+    case sortType::quick:       return "quick";
+    case sortType::threeWayQuick: return "threeWayQuick";
+    case sortType::merge:       return "merge";
+    case sortType::tim:         return "tim";
+    case sortType::heap:        return "heap";
+    case sortType::bottomUpHeap: return "bottomUpHeap";
+    case sortType::blockedHeap: return "blockedHeap";
+    case sortType::bufferedMerge: return "bufferedMerge";
+    case sortType::intro:       return "intro";
+    case sortType::blockQuick:  return "blockQuick";
+    case sortType::parallelMerge: return "parallelMerge";
+    case sortType::parallelQuick: return "parallelQuick";
+    case sortType::radix:       return "radix";
+    case sortType::networkIntro: return "networkIntro";
+    case sortType::networkMerge: return "networkMerge";
+    case sortType::genericQuick: return "genericQuick";
+    default:                    return "unknown";
+    }
+}
+
 std::string sortTypeToString(int sort) {
     switch (sort) {
     case sortType::insertion:   return "Insertion Sort";
     case sortType::quick:       return "Quick Sort";
+    case sortType::threeWayQuick: return "3-Way Quick Sort";
     case sortType::merge:       return "Merge Sort";
+    case sortType::tim:         return "Tim Sort";
     case sortType::heap:        return "Heap Sort";
+    case sortType::bottomUpHeap: return "Bottom-Up Heap Sort";
+    case sortType::blockedHeap: return "Blocked Heap Sort";
+    case sortType::bufferedMerge: return "Buffered Merge Sort";
+    case sortType::intro:       return "Intro Sort";
+    case sortType::blockQuick:  return "Block Quick Sort";
+    case sortType::parallelMerge: return "Parallel Merge Sort";
+    case sortType::parallelQuick: return "Parallel Quick Sort";
+    case sortType::radix:       return "Radix Sort";
+    case sortType::networkIntro: return "Network Intro Sort";
+    case sortType::networkMerge: return "Network Merge Sort";
+    case sortType::genericQuick: return "Generic Quick Sort";
     default:                    return "Unknown Sort";
     }
 }
@@ -226,7 +896,7 @@ std::string sortTypeToString(int sort) {
 void compareComparisons(int& fewestComparisonSort, sortResults sortResults[], const int SORT_RESULTS_SIZE) {
     fewestComparisonSort = 0;
     for (int i = 1; i < SORT_RESULTS_SIZE; i++) {
-        if (sortResults[i].comparisons < sortResults[fewestComparisonSort].comparisons) {
+        if (measured(sortResults[i]) && (!measured(sortResults[fewestComparisonSort]) || sortResults[i].comparisons < sortResults[fewestComparisonSort].comparisons)) {
             fewestComparisonSort = i;
         }
     }
@@ -236,7 +906,7 @@ void compareComparisons(int& fewestComparisonSort, sortResults sortResults[], co
 void compareMovements(int& fewestMovementsSort, sortResults sortResults[], const int SORT_RESULTS_SIZE) {
     fewestMovementsSort = 0;
     for (int i = 1; i < SORT_RESULTS_SIZE; i++) {
-        if (sortResults[i].movements < sortResults[fewestMovementsSort].movements) {
+        if (measured(sortResults[i]) && (!measured(sortResults[fewestMovementsSort]) || sortResults[i].movements < sortResults[fewestMovementsSort].movements)) {
             fewestMovementsSort = i;
         }
     }
@@ -246,94 +916,735 @@ void compareMovements(int& fewestMovementsSort, sortResults sortResults[], const
 void compareDuration(int& fastestSort, sortResults sortResults[], const int SORT_RESULTS_SIZE) {
     fastestSort = 0;
     for (int i = 1; i < SORT_RESULTS_SIZE; i++) {
-        if (sortResults[i].duration < sortResults[fastestSort].duration) {
+        if (measured(sortResults[i]) && (!measured(sortResults[fastestSort]) || sortResults[i].duration < sortResults[fastestSort].duration)) {
             fastestSort = i;
         }
     }
 }
 
-// Tests each sorting algorithm with an in order array
-void testInOrder(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[]) {
-    testSort(insertionSort, setAscendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::insertion]);
-    testSort(quickSort, setAscendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::quick]);
-    testSort(mergeSort, setAscendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::merge]);
-    testSort(heapSort, setAscendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::heap]);
+// Sets fastestUninstrumentedSort to the fastest sort with counting compiled out found in sortResults[]
+void compareUninstrumentedDuration(int& fastestUninstrumentedSort, sortResults sortResults[], const int SORT_RESULTS_SIZE) {
+    fastestUninstrumentedSort = 0;
+    for (int i = 1; i < SORT_RESULTS_SIZE; i++) {
+        if (measured(sortResults[i]) && (!measured(sortResults[fastestUninstrumentedSort]) || sortResults[i].uninstrumentedDuration < sortResults[fastestUninstrumentedSort].uninstrumentedDuration)) {
+            fastestUninstrumentedSort = i;
+        }
+    }
 }
 
-// Tests each sorting algorithm with a reverse order array
-void testReverseOrder(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[]) {
-    testSort(insertionSort, setDescendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::insertion]);
-    testSort(quickSort, setDescendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::quick]);
-    testSort(mergeSort, setDescendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::merge]);
-    testSort(heapSort, setDescendingArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::heap]);
+void genericQuickSort(int arr[], int n, sortResults& sortResult) {
+    genericQuickSort(arr, n, countingPolicy{ sortResult });
 }
 
-// Tests each sorting algorithm with a random order array
-void testRandomOrder(int testArray[], const int TEST_ARRAY_SIZE, sortResults sortResults[]) {
-    testSort(insertionSort, setRandomArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::insertion]);
-    testSort(quickSort, setRandomArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::quick]);
-    testSort(mergeSort, setRandomArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::merge]);
-    testSort(heapSort, setRandomArray, testArray, TEST_ARRAY_SIZE, sortResults[sortType::heap]);
+void blockedHeapSort(int arr[], int n, sortResults& sortResult) {
+    blockedHeapSort(arr, n, countingPolicy{ sortResult });
 }
 
-// Tests a given sorting algorithm on a given ordered array based on function pointers
-void testSort(void (*sort)(int[], int, sortResults&), void (*order)(int[], int), int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult) {
+// Times sort and uninstrumentedSort on arrays filled with distribution and stores the results in sortResult
+// The instrumented flavour runs settings.minIterations times for the averaged counts and Total Time,
+// while the uninstrumented flavour repeats until its 95% confidence interval is narrow enough or the time budget runs out
+template <typename Sort, typename UninstrumentedSort>
+void runSortTest(Sort sort, UninstrumentedSort uninstrumentedSort, int distribution, int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult, perfCounters* counters) {
     unsigned long long totalComparisons = 0, totalMovements = 0;
     unsigned long long totalDuration = 0;
+    std::vector<unsigned long long> uninstrumentedDurations;
+    unsigned long long totalHardwareCounts[HARDWARE_COUNTER_COUNT] = {};
+    auto testStart = std::chrono::high_resolution_clock::now();
     auto startTime = std::chrono::high_resolution_clock::now();
     auto endTime = std::chrono::high_resolution_clock::now();
 
-    for (int i = 0; i < TEST_ITERATIONS; i++) {
-        order(testArray, TEST_ARRAY_SIZE);
+    // Concurrent jobs already keep the cores busy, so they fill their arrays on their own thread
+    int generatorThreads = settings.jobs == 1 ? 0 : 1;
+
+    // Warmup runs settle caches, branch predictors, and the allocator, and are not recorded
+    for (int i = 0; i < settings.warmupIterations; i++) {
+        generateInput(testArray, TEST_ARRAY_SIZE, distribution, settings.seed, generatorThreads, settings.swaps);
+        uninstrumentedSort(testArray, TEST_ARRAY_SIZE);
+    }
+
+    for (int i = 0; i < settings.maxIterations; i++) {
+        if (i < settings.minIterations) {
+            generateInput(testArray, TEST_ARRAY_SIZE, distribution, settings.seed, generatorThreads, settings.swaps);
+
+            startTime = std::chrono::high_resolution_clock::now();
+
+            sort(testArray, TEST_ARRAY_SIZE);
 
+            endTime = std::chrono::high_resolution_clock::now();
+
+            totalDuration += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+            totalComparisons += sortResult.comparisons;
+            totalMovements += sortResult.movements;
+
+            // Reset these to avoid multiple test iterations causing incorrect values
+            sortResult.comparisons = 0;
+            sortResult.movements = 0;
+        }
+
+        // Re-run on the same input with counting compiled out to measure production speed
+        generateInput(testArray, TEST_ARRAY_SIZE, distribution, settings.seed, generatorThreads, settings.swaps);
+
+        if (counters) {
+            counters->start();
+        }
         startTime = std::chrono::high_resolution_clock::now();
 
-        sort(testArray, TEST_ARRAY_SIZE, sortResult);
+        uninstrumentedSort(testArray, TEST_ARRAY_SIZE);
 
         endTime = std::chrono::high_resolution_clock::now();
+        if (counters) {
+            counters->stop();
+            unsigned long long counts[HARDWARE_COUNTER_COUNT];
+            counters->read(counts);
+            for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+                totalHardwareCounts[counter] += counts[counter];
+            }
+        }
 
-        totalDuration += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
-        totalComparisons += sortResult.comparisons;
-        totalMovements += sortResult.movements;
+        uninstrumentedDurations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+
+        // Stop once the confidence interval is within the target fraction of the mean.
+        // A single run has no spread to measure, so the interval is only tested from two runs on
+        if (i + 1 >= settings.minIterations) {
+            computeTimingStatistics(uninstrumentedDurations, sortResult);
+            double mean = static_cast<double>(sortResult.uninstrumentedDuration);
+            if (sortResult.iterations >= 2 && confidenceHalfWidth(sortResult.stddevDuration, sortResult.iterations) <= settings.targetRelativeError * mean) {
+                break;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - testStart).count();
+            if (settings.timeBudget > 0 && elapsed > settings.timeBudget) {
+                break;
+            }
+        }
+    }
 
-        // Reset these to avoid multiple test iterations causing incorrect values
-        sortResult.comparisons = 0;
-        sortResult.movements = 0;
+    // Average result over every instrumented test
+    sortResult.duration = totalDuration / settings.minIterations;
+    sortResult.comparisons = totalComparisons / settings.minIterations;
+    sortResult.movements = totalMovements / settings.minIterations;
+    for (int counter = 0; counter < HARDWARE_COUNTER_COUNT; counter++) {
+        hardwareCount(sortResult, counter) = totalHardwareCounts[counter] / sortResult.iterations;
     }
+}
 
-    // Average result over every test
-    sortResult.duration = totalDuration / TEST_ITERATIONS;
-    sortResult.comparisons = totalComparisons / TEST_ITERATIONS;
-    sortResult.movements = totalMovements / TEST_ITERATIONS;
+// Tests one sorting algorithm on arrays filled with distribution, the same arrays every other sort sees
+void testSort(int sort, int distribution, int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult, perfCounters* counters) {
+    runSortTest(
+        [&](int arr[], int n) { sortBySortType(sort, arr, n, countingPolicy{ sortResult }); },
+        [&](int arr[], int n) { sortBySortType(sort, arr, n, noCountingPolicy{}); },
+        distribution, testArray, TEST_ARRAY_SIZE, sortResult, counters);
 }
 
-// Tests a given sorting algorithm on a given ordered array based on function pointers
-void testSort(void (*sort)(int[], int, int, sortResults&), void (*order)(int[], int), int testArray[], const int TEST_ARRAY_SIZE, sortResults& sortResult) {
-    unsigned long long totalComparisons = 0, totalMovements = 0;
-    unsigned long long totalDuration = 0;
-    auto startTime = std::chrono::high_resolution_clock::now();
-    auto endTime = std::chrono::high_resolution_clock::now();
+// Times the sort at BUDGET_PROBE_SIZE and twice that, and extrapolates the growth between them to TEST_ARRAY_SIZE.
+// The growth exponent is clamped to [1, 2], so an O(n^2) sort is predicted from the square of the size ratio
+double predictSortDuration(int sort, int distribution, const int TEST_ARRAY_SIZE) {
+    if (TEST_ARRAY_SIZE <= 2 * BUDGET_PROBE_SIZE) {
+        return 0; // Small enough that the budget check inside runSortTest suffices
+    }
 
-    for (int i = 0; i < TEST_ITERATIONS; i++) {
-        order(testArray, TEST_ARRAY_SIZE);
+    std::vector<int> probe(2 * BUDGET_PROBE_SIZE);
+    double probeDurations[2];
+    for (int step = 0; step < 2; step++) {
+        int size = BUDGET_PROBE_SIZE << step;
+        probeDurations[step] = 0;
+        for (int run = 0; run < BUDGET_PROBE_RUNS; run++) {
+            generateInput(probe.data(), size, distribution, settings.seed, 1, settings.swaps);
+            auto startTime = std::chrono::high_resolution_clock::now();
+            sortBySortType(sort, probe.data(), size, noCountingPolicy{});
+            auto endTime = std::chrono::high_resolution_clock::now();
+
+            // The fastest run is the least disturbed by other jobs
+            double duration = std::max(1.0, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count()));
+            probeDurations[step] = run == 0 ? duration : std::min(probeDurations[step], duration);
+        }
+    }
 
-        startTime = std::chrono::high_resolution_clock::now();
+    double exponent = std::min(2.0, std::max(1.0, std::log2(probeDurations[1] / probeDurations[0])));
+    return probeDurations[1] * std::pow(static_cast<double>(TEST_ARRAY_SIZE) / (2 * BUDGET_PROBE_SIZE), exponent);
+}
+
+bool measured(const sortResults& sortResult) {
+    return sortResult.iterations > 0;
+}
 
-        sort(testArray, 0, TEST_ARRAY_SIZE - 1, sortResult);
+bool usesThreads(int sort) {
+    return sort == sortType::parallelMerge || sort == sortType::parallelQuick;
+}
 
-        endTime = std::chrono::high_resolution_clock::now();
+// Times every selected sort on random arrays at each size of the sweep
+void sweepSizes(std::vector<sweepPoint>& points, const std::vector<int>& sorts) {
+    for (long long size = settings.sweepMinSize; size <= settings.sweepMaxSize;
+        size = std::max(size + 1, std::llround(static_cast<double>(size) * settings.sweepSizeFactor))) {
+        sweepPoint point{};
+        point.size = static_cast<int>(size);
+
+        // Small arrays finish faster than the clock can resolve, so they are sorted as a batch of independent arrays
+        int batch = std::max(1, SWEEP_BATCH_ELEMENTS / point.size);
+        std::size_t elements = static_cast<std::size_t>(batch) * point.size;
+
+        // Every sort sorts copies of the same random input
+        std::vector<int> input(elements), work(elements);
+        generateInput(input.data(), static_cast<int>(elements), randomInput, settings.seed);
+
+        for (int sort : sorts) {
+            if (sort == sortType::insertion && point.size > SWEEP_QUADRATIC_LIMIT) {
+                continue;
+            }
+            sortResults& sortResult = point.results[sort];
+            point.measured[sort] = true;
+
+            // Instrumented pass for the counts, averaged over the batch
+            std::copy(input.begin(), input.end(), work.begin());
+            for (int b = 0; b < batch; b++) {
+                sortBySortType(sort, work.data() + static_cast<std::size_t>(b) * point.size, point.size, countingPolicy{ sortResult });
+            }
+            sortResult.comparisons /= batch;
+            sortResult.movements /= batch;
+
+            std::vector<unsigned long long> durations;
+            for (int i = 0; i < settings.warmupIterations + settings.minIterations; i++) {
+                std::copy(input.begin(), input.end(), work.begin());
+
+                auto startTime = std::chrono::high_resolution_clock::now();
+                for (int b = 0; b < batch; b++) {
+                    sortBySortType(sort, work.data() + static_cast<std::size_t>(b) * point.size, point.size, noCountingPolicy{});
+                }
+                auto endTime = std::chrono::high_resolution_clock::now();
+
+                if (i >= settings.warmupIterations) {
+                    durations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() / batch);
+                }
+            }
+            computeTimingStatistics(durations, sortResult);
+        }
+
+        points.push_back(point);
+    }
+}
+
+// Nanoseconds per element from the median uninstrumented run, and comparisons per n log2 n
+static double nsPerElement(const sweepPoint& point, int sort) {
+    return static_cast<double>(point.results[sort].medianDuration) / point.size;
+}
+static double comparisonsPerNLogN(const sweepPoint& point, int sort) {
+    return point.size > 1 ? static_cast<double>(point.results[sort].comparisons) / (point.size * std::log2(point.size)) : 0;
+}
 
-        totalDuration += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
-        totalComparisons += sortResult.comparisons;
-        totalMovements += sortResult.movements;
+// The measured sort with the fastest median at a point
+static int fastestAt(const sweepPoint& point, const std::vector<int>& sorts) {
+    int fastest = -1;
+    for (int sort : sorts) {
+        if (point.measured[sort] && (fastest < 0 || point.results[sort].medianDuration < point.results[fastest].medianDuration)) {
+            fastest = sort;
+        }
+    }
+    return fastest;
+}
+
+// Prints a table of metric for every selected sort at every size, along with the fastest sort
+static void printSweepTable(const std::string& title, const std::vector<sweepPoint>& points, const std::vector<int>& sorts,
+    double (*metric)(const sweepPoint&, int)) {
+    // Formatting
+    constexpr int sizeWidth = 12;
+    constexpr int numWidth = 14;
 
-        // Reset these to avoid multiple test iterations causing incorrect values
-        sortResult.comparisons = 0;
-        sortResult.movements = 0;
+    std::cout << title << ":\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    std::cout << std::left << std::setw(sizeWidth) << "Size";
+    for (int sort : sorts) {
+        std::cout << std::right << std::setw(numWidth) << sortTypeToKey(sort);
+    }
+    std::cout << std::right << std::setw(numWidth) << "fastest" << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const sweepPoint& point : points) {
+        std::cout << std::left << std::setw(sizeWidth) << point.size << std::right;
+        for (int sort : sorts) {
+            if (point.measured[sort]) {
+                std::cout << std::setw(numWidth) << metric(point, sort);
+            }
+            else {
+                std::cout << std::setw(numWidth) << "-";
+            }
+        }
+        std::cout << std::setw(numWidth) << sortTypeToKey(fastestAt(point, sorts)) << "\n";
     }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << std::string(barWidth, '-') << "\n\n";
+}
+
+void printSweep(const std::vector<sweepPoint>& points, const std::vector<int>& sorts) {
+    std::cout << "Size Sweep - Random Input: " << settings.sweepMinSize << " to " << settings.sweepMaxSize
+        << " elements, x" << settings.sweepSizeFactor << " per step, median of " << settings.minIterations << " run(s)\n\n";
+
+    printSweepTable("Uninstrumented Time per Element (ns)", points, sorts, nsPerElement);
+    printSweepTable("Comparisons per n log2 n", points, sorts, comparisonsPerNLogN);
+
+    // Fit ns/element = a * log2 n + b and comparisons/n = c * log2 n + d, so a and c are the n log n constants
+    constexpr int numWidth = 16;
+    std::cout << "Scaling Fits (time per element = a log2 n + b, comparisons per element = c log2 n + d):\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    std::cout << std::left << std::setw(nameWidth) << "Sort Type"
+        << std::right << std::setw(numWidth) << "a (ns)"
+        << std::setw(numWidth) << "b (ns)"
+        << std::setw(numWidth) << "c"
+        << std::setw(numWidth) << "d" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (int sort : sorts) {
+        std::vector<double> logSizes, times, comparisons;
+        for (const sweepPoint& point : points) {
+            if (point.measured[sort]) {
+                logSizes.push_back(std::log2(point.size));
+                times.push_back(nsPerElement(point, sort));
+                comparisons.push_back(static_cast<double>(point.results[sort].comparisons) / point.size);
+            }
+        }
+        double a = 0, b = 0, c = 0, d = 0;
+        fitLine(logSizes, times, a, b);
+        fitLine(logSizes, comparisons, c, d);
+        std::cout << std::left << std::setw(nameWidth) << sortTypeToString(sort)
+            << std::right << std::setw(numWidth) << a
+            << std::setw(numWidth) << b
+            << std::setw(numWidth) << c
+            << std::setw(numWidth) << d << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << std::string(barWidth, '-') << "\n\n";
+
+    // Where the fastest sort changes, interpolate the size at which the two sorts tie in log2 n
+    std::cout << "Crossovers:\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    bool anyCrossover = false;
+    for (std::size_t i = 1; i < points.size(); i++) {
+        int before = fastestAt(points[i - 1], sorts);
+        int after = fastestAt(points[i], sorts);
+        if (before == after) {
+            continue;
+        }
+
+        double crossover = points[i].size;
+        if (points[i - 1].measured[after] && points[i].measured[before]) {
+            double gapBefore = nsPerElement(points[i - 1], before) - nsPerElement(points[i - 1], after);
+            double gapAfter = nsPerElement(points[i], before) - nsPerElement(points[i], after);
+            double logBefore = std::log2(points[i - 1].size), logAfter = std::log2(points[i].size);
+            if (gapAfter != gapBefore) {
+                crossover = std::exp2(logBefore + (logAfter - logBefore) * -gapBefore / (gapAfter - gapBefore));
+            }
+        }
+
+        std::cout << std::left << std::setw(nameWidth) << sortTypeToString(before) << " -> "
+            << std::setw(nameWidth) << sortTypeToString(after) << " at n ~ " << std::llround(crossover) << "\n";
+        anyCrossover = true;
+    }
+    if (!anyCrossover) {
+        std::cout << "None, " << sortTypeToString(fastestAt(points.front(), sorts)) << " is fastest at every size\n";
+    }
+    std::cout << std::string(barWidth, '-') << "\n";
+}
+
+bool writeSweepCsv(const std::string& path, const std::vector<sweepPoint>& points, const std::vector<int>& sorts) {
+    std::ofstream file(path);
+    file << "size,algorithm,comparisons,movements,runs,median_ns,min_ns,ns_per_element,comparisons_per_nlogn\n";
+    for (const sweepPoint& point : points) {
+        for (int sort : sorts) {
+            if (!point.measured[sort]) {
+                continue;
+            }
+            const sortResults& result = point.results[sort];
+            file << point.size << ',' << sortTypeToKey(sort) << ',' << result.comparisons << ',' << result.movements << ','
+                << result.iterations << ',' << result.medianDuration << ',' << result.minDuration << ','
+                << nsPerElement(point, sort) << ',' << comparisonsPerNLogN(point, sort) << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// A record of an int key and PayloadBytes of payload, for --records
+template <int PayloadBytes>
+struct benchmarkRecord {
+    int key;
+    char payload[PayloadBytes];
+};
+
+// Times sort(counter) on fresh copies of input in work: once counted, then warmup and settings.minIterations uninstrumented runs
+template <typename Element, typename Sort>
+sortResults timeOnCopies(const std::vector<Element>& input, std::vector<Element>& work, Sort sort) {
+    sortResults sortResult{};
+    work = input;
+    sort(countingPolicy{ sortResult });
+
+    std::vector<unsigned long long> durations;
+    for (int i = 0; i < settings.warmupIterations + settings.minIterations; i++) {
+        work = input;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        sort(noCountingPolicy{});
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        if (i >= settings.warmupIterations) {
+            durations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+        }
+    }
+    computeTimingStatistics(durations, sortResult);
+    return sortResult;
+}
+
+// Prints one row of the --records table
+static void printRecordSortRow(std::size_t recordBytes, const std::string& method, const sortResults& sortResult, std::size_t records, bool sorted) {
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << std::left << std::setw(numWidth - 2) << recordBytes << std::setw(nameWidth) << method
+        << std::right << std::setw(numWidth) << sortResult.comparisons
+        << std::setw(numWidth) << sortResult.movements
+        << std::setw(numWidth) << sortResult.medianDuration
+        << std::setw(numWidth) << std::fixed << std::setprecision(2) << static_cast<double>(sortResult.medianDuration) / records
+        << std::setw(numWidth) << static_cast<double>(records) * 1000 / sortResult.medianDuration << std::defaultfloat << std::setprecision(6)
+        << std::setw(numWidth - 6) << (sorted ? "Yes" : "No") << "\n";
+}
+
+// Sorts records of PayloadBytes payload with the given keys directly, by argsort, and by pair sort in place and through a buffer
+template <int PayloadBytes>
+void benchmarkRecordSorts(const std::vector<int>& keys) {
+    using record = benchmarkRecord<PayloadBytes>;
+
+    std::vector<record> input(keys.size()), work;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        input[i].key = keys[i];
+    }
+    auto keyOrder = [](const record& a, const record& b) { return a.key < b.key; };
+
+    // Direct sort moves whole records through the generic introspective Quick Sort
+    sortResults direct = timeOnCopies(input, work, [&](auto counter) {
+        quickSort(work.begin(), work.end(), std::less<>(), &record::key, counter);
+    });
+    printRecordSortRow(sizeof(record), "Direct Sort", direct, keys.size(), std::is_sorted(work.begin(), work.end(), keyOrder));
+
+    // Argsort leaves the records in place, so the check reads the keys through the index
+    std::vector<std::uint32_t> index;
+    sortResults indexed = timeOnCopies(input, work, [&](auto counter) {
+        index = argSort(work.begin(), work.end(), &record::key, counter);
+    });
+    bool indexSorted = true;
+    for (std::size_t i = 1; i < index.size(); i++) {
+        indexSorted = indexSorted && work[index[i - 1]].key <= work[index[i]].key;
+    }
+    printRecordSortRow(sizeof(record), "Argsort", indexed, keys.size(), indexSorted);
+
+    sortResults paired = timeOnCopies(input, work, [&](auto counter) {
+        pairSort(work.begin(), work.end(), &record::key, counter);
+    });
+    printRecordSortRow(sizeof(record), "Pair Sort", paired, keys.size(), std::is_sorted(work.begin(), work.end(), keyOrder));
+
+    // Reusing one scratch buffer, already faulted in, turns the permutation into a prefetched gather
+    std::vector<record> scratch(keys.size());
+    sortResults buffered = timeOnCopies(input, work, [&](auto counter) {
+        pairSort(work.begin(), work.end(), &record::key, counter, scratch.data());
+    });
+    printRecordSortRow(sizeof(record), "Pair Sort (Buffer)", buffered, keys.size(), std::is_sorted(work.begin(), work.end(), keyOrder));
+}
 
-    // Average result over every test
-    sortResult.duration = totalDuration / TEST_ITERATIONS;
-    sortResult.comparisons = totalComparisons / TEST_ITERATIONS;
-    sortResult.movements = totalMovements / TEST_ITERATIONS;
-}
\ No newline at end of file
+int runRecordSort(int argc, char* argv[]) {
+    // Flags follow --records, so parse as if it were the program name
+    if (!parseBenchmarkSettings(argc - 1, argv + 1)) {
+        std::cerr << "Usage: " << argv[0] << " --records [--size N] [--seed N] [--warmup N] [--min-runs N]\n";
+        return 1;
+    }
+
+    std::vector<int> keys(settings.arraySize);
+    generateInput(keys.data(), settings.arraySize, randomInput, settings.seed);
+
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << "Record Sort - Random Keys: " << settings.arraySize << " records, median of " << settings.minIterations << " run(s)\n\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    std::cout << std::left << std::setw(numWidth - 2) << "Record Bytes" << std::setw(nameWidth) << "Method"
+        << std::right << std::setw(numWidth) << "Comparisons"
+        << std::setw(numWidth) << "Movements"
+        << std::setw(numWidth) << "Median (ns)"
+        << std::setw(numWidth) << "ns/Record"
+        << std::setw(numWidth) << "Records/us"
+        << std::setw(numWidth - 6) << "Sorted" << "\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+
+    // 16, 64, and 256 byte records
+    benchmarkRecordSorts<12>(keys);
+    benchmarkRecordSorts<60>(keys);
+    benchmarkRecordSorts<252>(keys);
+
+    std::cout << std::string(barWidth, '-') << "\n";
+    return 0;
+}
+
+// Prints one row of the --select table, with the speedup over a full sort
+static void printSelectionRow(const std::string& k, const std::string& method, const sortResults& sortResult, const sortResults& fullSort, bool correct) {
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << std::left << std::setw(numWidth - 4) << k << std::setw(nameWidth) << method
+        << std::right << std::setw(numWidth) << sortResult.comparisons
+        << std::setw(numWidth) << sortResult.movements
+        << std::setw(numWidth) << sortResult.medianDuration
+        << std::setw(numWidth) << std::fixed << std::setprecision(2) << static_cast<double>(fullSort.medianDuration) / sortResult.medianDuration
+        << std::defaultfloat << std::setprecision(6)
+        << std::setw(numWidth - 6) << (correct ? "Yes" : "No") << "\n";
+}
+
+int runSelection(int argc, char* argv[]) {
+    // Flags follow --select, so parse as if it were the program name
+    if (!parseBenchmarkSettings(argc - 1, argv + 1)) {
+        std::cerr << "Usage: " << argv[0] << " --select [--size N] [--seed N] [--warmup N] [--min-runs N]\n";
+        return 1;
+    }
+
+    const int n = settings.arraySize;
+    std::vector<int> input(n), work;
+    generateInput(input.data(), n, randomInput, settings.seed);
+    std::vector<int> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << "Selection - Random Input: " << n << " elements, median of " << settings.minIterations << " run(s)\n\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    std::cout << std::left << std::setw(numWidth - 4) << "k" << std::setw(nameWidth) << "Method"
+        << std::right << std::setw(numWidth) << "Comparisons"
+        << std::setw(numWidth) << "Movements"
+        << std::setw(numWidth) << "Median (ns)"
+        << std::setw(numWidth) << "x Full Sort"
+        << std::setw(numWidth - 6) << "Correct" << "\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+
+    // Every method is measured against sorting the whole array
+    sortResults fullSort = timeOnCopies(input, work, [&](auto counter) { introSort(work.data(), n, counter); });
+    printSelectionRow(std::to_string(n), "Intro Sort", fullSort, fullSort, work == sorted);
+
+    int previousK = 0;
+    for (int k : { 1, 10, 100, 1000, n / 10, n / 2 }) {
+        if (k <= previousK || k > n) {
+            continue;
+        }
+        previousK = k;
+
+        // Quickselect leaves the k smallest in front, unsorted, with the k-th in its sorted position
+        sortResults selected = timeOnCopies(input, work, [&](auto counter) { nthElement(work.data(), n, k - 1, counter); });
+        bool selectedCorrect = work[k - 1] == sorted[k - 1]
+            && *std::max_element(work.begin(), work.begin() + k) == sorted[k - 1]
+            && *std::min_element(work.begin() + (k - 1), work.end()) == sorted[k - 1];
+        printSelectionRow(std::to_string(k), "Quickselect", selected, fullSort, selectedCorrect);
+
+        // Quickselect, then sorting only the front, is the O(n + k log k) partial sort
+        sortResults selectedSorted = timeOnCopies(input, work, [&](auto counter) {
+            nthElement(work.data(), n, k - 1, counter);
+            introSort(work.data(), k, counter);
+        });
+        printSelectionRow(std::to_string(k), "Quickselect + Sort", selectedSorted, fullSort, std::equal(work.begin(), work.begin() + k, sorted.begin()));
+
+        sortResults partial = timeOnCopies(input, work, [&](auto counter) { partialSort(work.data(), n, k, counter); });
+        printSelectionRow(std::to_string(k), "Partial Sort", partial, fullSort, std::equal(work.begin(), work.begin() + k, sorted.begin()));
+
+        // The stream sees each element once and never writes to the array
+        std::vector<int> top;
+        sortResults streamed = timeOnCopies(input, work, [&](auto counter) {
+            streamingTopK stream(k);
+            for (int value : work) {
+                stream.push(value, counter);
+            }
+            top = stream.sorted(counter);
+        });
+        printSelectionRow(std::to_string(k), "Streaming Top-K", streamed, fullSort, std::equal(top.begin(), top.end(), sorted.begin()) && static_cast<int>(top.size()) == k);
+    }
+
+    std::cout << std::string(barWidth, '-') << "\n";
+    return 0;
+}
+
+// One way of sorting input that arrives in batches, for --stream
+struct batchedSortResults {
+    sortResults counted{};     // Comparisons and movements of one counted run
+    sortResults firstResult{}; // Timings from the end of the input to the first value
+    sortResults total{};       // Timings from the first batch to the last value
+    std::size_t spilledRuns = 0;
+    bool sorted = true;
+};
+
+// Feeds input in batchCount batches and takes every value out in order, once counted, then warmup and settings.minIterations timed runs.
+// The streaming sorter sorts as the batches arrive; otherwise they are buffered into one array for a single Intro Sort call
+static batchedSortResults timeBatchedSort(const std::vector<int>& input, const std::vector<int>& sorted, int batchCount, bool streaming, std::size_t memoryBudget) {
+    const int n = static_cast<int>(input.size());
+    batchedSortResults result;
+    std::vector<int> output(n);
+    std::vector<unsigned long long> firstDurations, totalDurations;
+
+    for (int i = -1; i < settings.warmupIterations + settings.minIterations; i++) {
+        sortResults uncounted{};
+        sortResults& counts = i < 0 ? result.counted : uncounted;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto inputEnd = startTime, firstTime = startTime;
+        if (streaming) {
+            streamingSorter sorter(memoryBudget, "", counts);
+            for (int batch = 0; batch < batchCount; batch++) {
+                int begin = static_cast<int>(static_cast<long long>(n) * batch / batchCount);
+                int end = static_cast<int>(static_cast<long long>(n) * (batch + 1) / batchCount);
+                sorter.push(input.data() + begin, end - begin);
+            }
+            inputEnd = std::chrono::high_resolution_clock::now();
+            result.spilledRuns = sorter.spilledRunCount(); // Before the first value merges them down to what fits
+            if (n > 0) {
+                sorter.next(output[0]);
+            }
+            firstTime = std::chrono::high_resolution_clock::now();
+            if (n > 1) {
+                sorter.next(output.data() + 1, n - 1);
+            }
+        }
+        else {
+            // The total is unknown until the input ends, so the buffer grows batch by batch
+            std::vector<int> buffer;
+            for (int batch = 0; batch < batchCount; batch++) {
+                int begin = static_cast<int>(static_cast<long long>(n) * batch / batchCount);
+                int end = static_cast<int>(static_cast<long long>(n) * (batch + 1) / batchCount);
+                buffer.insert(buffer.end(), input.begin() + begin, input.begin() + end);
+            }
+            counts.movements += n;
+            inputEnd = std::chrono::high_resolution_clock::now();
+            introSort(buffer.data(), n, counts);
+            firstTime = std::chrono::high_resolution_clock::now();
+            std::copy(buffer.begin(), buffer.end(), output.begin());
+            counts.movements += n;
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        result.sorted = result.sorted && output == sorted;
+        if (i >= settings.warmupIterations) {
+            firstDurations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(firstTime - inputEnd).count());
+            totalDurations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count());
+        }
+    }
+    computeTimingStatistics(firstDurations, result.firstResult);
+    computeTimingStatistics(totalDurations, result.total);
+    return result;
+}
+
+// Prints one row of the --stream table
+static void printStreamingRow(int batchCount, const std::string& method, const batchedSortResults& result, int n) {
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << std::left << std::setw(numWidth - 2) << batchCount << std::setw(nameWidth) << method
+        << std::right << std::setw(numWidth) << result.counted.comparisons
+        << std::setw(numWidth - 2) << result.spilledRuns
+        << std::setw(numWidth) << result.firstResult.medianDuration
+        << std::setw(numWidth) << result.total.medianDuration
+        << std::setw(numWidth - 2) << std::fixed << std::setprecision(2) << static_cast<double>(result.total.medianDuration) / n
+        << std::defaultfloat << std::setprecision(6)
+        << std::setw(numWidth - 6) << (result.sorted ? "Yes" : "No") << "\n";
+}
+
+int runStreamingSort(int argc, char* argv[]) {
+    // Flags follow --stream, so parse as if it were the program name
+    if (!parseBenchmarkSettings(argc - 1, argv + 1)) {
+        std::cerr << "Usage: " << argv[0] << " --stream [--size N] [--seed N] [--warmup N] [--min-runs N]\n";
+        return 1;
+    }
+
+    const int n = settings.arraySize;
+    std::vector<int> input(n);
+    generateInput(input.data(), n, randomInput, settings.seed);
+    std::vector<int> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+
+    // A quarter of the input, so the budgeted sorter spills at any size above the 1.5 MiB minimum budget
+    std::size_t spillBudget = std::max<std::size_t>(6 * 256 * 1024, input.size() * sizeof(int) / 4);
+
+    // Formatting
+    constexpr int numWidth = 16;
+
+    std::cout << "Streaming Sort - Random Input: " << n << " elements in batches, median of " << settings.minIterations << " run(s)\n";
+    std::cout << "First Result is the time from the last batch to the first sorted value, Total from the first batch to the last value\n";
+    std::cout << "The budgeted sorter holds at most " << spillBudget / 1024 << " KiB and spills the rest to temporary files\n\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+    std::cout << std::left << std::setw(numWidth - 2) << "Batches" << std::setw(nameWidth) << "Method"
+        << std::right << std::setw(numWidth) << "Comparisons"
+        << std::setw(numWidth - 2) << "Spilled Runs"
+        << std::setw(numWidth) << "First Result"
+        << std::setw(numWidth) << "Total (ns)"
+        << std::setw(numWidth - 2) << "ns/Element"
+        << std::setw(numWidth - 6) << "Sorted" << "\n";
+    std::cout << std::string(barWidth, '-') << "\n";
+
+    for (int batchCount : { 1, 16, 256, 4096 }) {
+        if (batchCount > std::max(1, n)) {
+            continue;
+        }
+        printStreamingRow(batchCount, "Intro Sort (1 Call)", timeBatchedSort(input, sorted, batchCount, false, 0), n);
+        printStreamingRow(batchCount, "Streaming Sorter", timeBatchedSort(input, sorted, batchCount, true, 0), n);
+        printStreamingRow(batchCount, "Streaming (Budget)", timeBatchedSort(input, sorted, batchCount, true, spillBudget), n);
+    }
+
+    std::cout << std::string(barWidth, '-') << "\n";
+    return 0;
+}
+
+// Two-sided 95% Student's t critical values for 1 to 30 degrees of freedom
+static const double T_CRITICAL_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+double confidenceHalfWidth(double stddev, unsigned long long samples) {
+    if (samples < 2) {
+        return 0;
+    }
+    unsigned long long degreesOfFreedom = samples - 1;
+    double t = degreesOfFreedom <= 30 ? T_CRITICAL_95[degreesOfFreedom - 1] : 1.960;
+    return t * stddev / std::sqrt(static_cast<double>(samples));
+}
+
+void computeTimingStatistics(std::vector<unsigned long long> durations, sortResults& sortResult) {
+    std::sort(durations.begin(), durations.end());
+    unsigned long long n = durations.size();
+
+    double mean = 0;
+    for (unsigned long long duration : durations) {
+        mean += static_cast<double>(duration);
+    }
+    mean /= static_cast<double>(n);
+
+    double squaredDeviations = 0;
+    for (unsigned long long duration : durations) {
+        squaredDeviations += (duration - mean) * (duration - mean);
+    }
+
+    sortResult.iterations = n;
+    sortResult.uninstrumentedDuration = static_cast<unsigned long long>(mean);
+    sortResult.minDuration = durations.front();
+    sortResult.medianDuration = n % 2 == 1 ? durations[n / 2] : (durations[n / 2 - 1] + durations[n / 2]) / 2;
+    sortResult.p95Duration = durations[(95 * n + 99) / 100 - 1]; // Nearest rank
+    sortResult.stddevDuration = n > 1 ? std::sqrt(squaredDeviations / static_cast<double>(n - 1)) : 0;
+}
+
+void fitLine(const std::vector<double>& x, const std::vector<double>& y, double& slope, double& intercept) {
+    double n = static_cast<double>(x.size());
+    double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (std::size_t i = 0; i < x.size(); i++) {
+        sumX += x[i];
+        sumY += y[i];
+        sumXX += x[i] * x[i];
+        sumXY += x[i] * y[i];
+    }
+
+    double denominator = n * sumXX - sumX * sumX;
+    if (x.empty() || denominator == 0) {
+        // Zero or one distinct size leaves only a constant to fit
+        slope = 0;
+        intercept = x.empty() ? 0 : sumY / n;
+        return;
+    }
+    slope = (n * sumXY - sumX * sumY) / denominator;
+    intercept = (sumY - slope * sumX) / n;
+}